@@ -0,0 +1,136 @@
+#include "batch.h"
+#include "input.h"
+#include "json_util.h"
+#include "solver.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Parse, validate and solve one scenario into a single JSON line
+std::string solveScenario(const std::string& path, const BatchOptions& batchOptions, bool& succeeded) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsedMillis = [&start] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::string record = "{\"scenario\":" + jsonString(path);
+    succeeded = false;
+
+    try {
+        GlobalConstraints globalConstraints{};
+        std::vector<Objective> objectives;
+        auto products = parseInputConfig(path, globalConstraints, objectives);
+
+        // Warnings are accepted without prompting, critical errors skip the solve
+        ValidationReport report = collectValidationIssues(products, globalConstraints);
+        if (!report.criticalErrors.empty()) {
+            return record + ",\"status\":\"invalid\",\"message\":" + jsonString(report.criticalErrors.front()) +
+                   ",\"critical_errors\":" + std::to_string(report.criticalCount) +
+                   ",\"millis\":" + jsonNumber(elapsedMillis()) + "}";
+        }
+
+        SolverOptions options;
+        options.verbose = false;
+        options.cacheDir = batchOptions.cacheDir;
+        options.cacheMaxBytes = batchOptions.cacheMaxBytes;
+        options.algorithm = batchOptions.algorithm;
+        options.presolve = batchOptions.presolve;
+        Solver solver(products, globalConstraints, objectives, options);
+        SolveResult result = solver.solve();
+        succeeded = result.status == 0;
+
+        record += ",\"status\":" + jsonString(solveStatusName(result.status)) +
+                  ",\"products\":" + std::to_string(products.size()) +
+                  ",\"warnings\":" + std::to_string(report.warningCount) +
+                  ",\"objective\":" + jsonNumber(result.objectiveValue) +
+                  ",\"profit\":" + jsonNumber(result.totalProfit) +
+                  ",\"budget_used\":" + jsonNumber(result.totalBudgetUsed) +
+                  ",\"man_hours_used\":" + jsonNumber(result.totalManHoursUsed) +
+                  ",\"iterations\":" + std::to_string(result.iterations) +
+                  ",\"clp_algorithm\":" + jsonString(result.algorithm == LpAlgorithm::Auto ? "none"
+                                                                                         : lpAlgorithmName(result.algorithm)) +
+                  ",\"cache\":" + jsonString(cacheLookupName(result.cache)) +
+                  ",\"millis\":" + jsonNumber(elapsedMillis()) + "}";
+    } catch (const std::exception& ex) {
+        record += ",\"status\":\"error\",\"message\":" + jsonString(ex.what()) +
+                  ",\"millis\":" + jsonNumber(elapsedMillis()) + "}";
+    }
+    return record;
+}
+
+} // namespace
+
+std::vector<std::string> collectScenarios(const std::string& source) {
+    std::vector<std::string> scenarios;
+
+    if (fs::is_directory(source)) {
+        for (const auto& entry : fs::directory_iterator(source)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".config") {
+                scenarios.push_back(entry.path().string());
+            }
+        }
+        std::sort(scenarios.begin(), scenarios.end());
+        return scenarios;
+    }
+
+    std::ifstream manifest(source);
+    if (!manifest.is_open()) {
+        throw std::runtime_error("Failed to open scenario source: " + source);
+    }
+
+    fs::path baseDir = fs::path(source).parent_path();
+    std::string line;
+    while (std::getline(manifest, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+        size_t end = line.find_last_not_of(" \t\r");
+        fs::path scenario = line.substr(start, end - start + 1);
+        scenarios.push_back(scenario.is_absolute() ? scenario.string() : (baseDir / scenario).string());
+    }
+    return scenarios;
+}
+
+size_t runBatch(const BatchOptions& options) {
+    std::vector<std::string> scenarios = collectScenarios(options.source);
+
+    std::ofstream output(options.outputFile);
+    if (!output.is_open()) {
+        throw std::runtime_error("Failed to open batch output file: " + options.outputFile);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> records(scenarios.size());
+    std::atomic<size_t> failures{0};
+
+    ThreadPool pool(options.threads);
+    // One task per scenario: every worker owns at most one ClpSimplex at a time
+    for (size_t i = 0; i < scenarios.size(); ++i) {
+        pool.submit([&, i] {
+            bool succeeded = false;
+            records[i] = solveScenario(scenarios[i], options, succeeded);
+            if (!succeeded) {
+                failures.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    pool.wait();
+
+    // Written in scenario order so runs can be diffed
+    for (const auto& record : records) {
+        output << record << '\n';
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Solved " << scenarios.size() << " scenarios (" << failures.load() << " not optimal) in "
+              << seconds << " s using " << pool.size() << " threads. Results: " << options.outputFile << "\n";
+    return failures.load();
+}
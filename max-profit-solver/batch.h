@@ -0,0 +1,29 @@
+// batch.h
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "lp_algorithm.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Batch scenario run configuration
+struct BatchOptions {
+    std::string source;      // Directory of *.config files or a manifest file
+    std::string outputFile;  // JSON lines, one record per scenario
+    unsigned threads = 0;    // 0 = all cores
+    std::string cacheDir;    // Shared solution cache, empty = off
+    uint64_t cacheMaxBytes = 256ull << 20;
+    LpAlgorithm algorithm = LpAlgorithm::Auto;
+    bool presolve = false;
+};
+
+// Resolve the scenario list: every *.config in a directory (sorted), or one
+// path per line of a manifest file, relative to the manifest's directory
+std::vector<std::string> collectScenarios(const std::string& source);
+
+// Solve every scenario on a work-stealing pool, never reading stdin.
+// Returns the number of scenarios that failed or were not optimal.
+size_t runBatch(const BatchOptions& options);
+
+#endif // BATCH_H
@@ -0,0 +1,445 @@
+#include "catalog_generator.h"
+#include "input.h"
+#include "json_util.h"
+#include "model_file.h"
+#include "solver.h"
+#include "validation_kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The getline/istringstream/stod parser that parseInputConfig replaced,
+// kept here as the baseline for the parse benchmark
+namespace legacy {
+
+std::string trim(const std::string& str) {
+    size_t start = str.find_first_not_of(" \t");
+    size_t end = str.find_last_not_of(" \t");
+    return (start == std::string::npos || end == std::string::npos) ? "" : str.substr(start, end - start + 1);
+}
+
+std::pair<double, double> parseRange(const std::string& value) {
+    std::istringstream ss(value);
+    std::string min, max;
+    if (std::getline(ss, min, ',') && std::getline(ss, max, ',')) {
+        return {std::stod(trim(min)), std::stod(trim(max))};
+    }
+    throw std::invalid_argument("Invalid range format: " + value);
+}
+
+std::unordered_map<std::string, Product> parseInputConfig(const std::string& filename, GlobalConstraints& globalConstraints, std::vector<Objective>& objectives) {
+    std::unordered_map<std::string, Product> products;
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open input file: " + filename);
+    }
+
+    std::string line, currentSection;
+    Product currentProduct;
+    while (std::getline(file, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        if (line[0] == '[' && line.back() == ']') {
+            if (!currentSection.empty() && currentSection != "Global" && currentSection != "Objectives") {
+                products[currentProduct.name] = currentProduct;
+            }
+            currentSection = line.substr(1, line.size() - 2);
+            if (currentSection != "Global" && currentSection != "Objectives") {
+                currentProduct = Product{};
+            }
+            continue;
+        }
+
+        size_t delimiterPos = line.find('=');
+        if (delimiterPos == std::string::npos) {
+            throw std::invalid_argument("Invalid config line: " + line);
+        }
+        std::string key = trim(line.substr(0, delimiterPos));
+        std::string value = trim(line.substr(delimiterPos + 1));
+
+        if (currentSection == "Global") {
+            if (key == "global_budget") {
+                std::tie(globalConstraints.budgetMin, globalConstraints.budgetMax) = parseRange(value);
+            } else if (key == "global_profit") {
+                std::tie(globalConstraints.profitMin, globalConstraints.profitMax) = parseRange(value);
+            } else if (key == "global_man_hours") {
+                std::tie(globalConstraints.manHoursMin, globalConstraints.manHoursMax) = parseRange(value);
+            }
+        } else if (currentSection == "Objectives") {
+            size_t spacePos = key.find('_');
+            if (spacePos == std::string::npos) {
+                throw std::invalid_argument("Invalid objective key: " + key);
+            }
+            std::string type = key.substr(0, spacePos);
+            std::string name = key.substr(spacePos + 1);
+            if (type != "maximize" && type != "minimize") {
+                throw std::invalid_argument("Invalid objective type: " + type);
+            }
+            auto rank_value = std::stoi(value);
+            objectives.push_back({name, type, rank_value > 10 ? 10 : rank_value});
+        } else {
+            if (key == "product_name") {
+                currentProduct.name = value;
+            } else if (key == "cost_range") {
+                std::tie(currentProduct.costMin, currentProduct.costMax) = parseRange(value);
+            } else if (key == "profit_range") {
+                std::tie(currentProduct.profitMin, currentProduct.profitMax) = parseRange(value);
+            } else if (key == "demand_range") {
+                std::tie(currentProduct.demandMin, currentProduct.demandMax) = parseRange(value);
+            } else if (key == "budget_range") {
+                std::tie(currentProduct.budgetMin, currentProduct.budgetMax) = parseRange(value);
+            } else if (key == "man_hour_per_unit") {
+                std::tie(currentProduct.manHourPerUnitMin, currentProduct.manHourPerUnitMax) = parseRange(value);
+            } else if (key == "total_man_hours") {
+                std::tie(currentProduct.totalManHoursMin, currentProduct.totalManHoursMax) = parseRange(value);
+            }
+        }
+    }
+
+    if (!currentSection.empty() && currentSection != "Global" && currentSection != "Objectives") {
+        products[currentProduct.name] = currentProduct;
+    }
+    return products;
+}
+
+} // namespace legacy
+
+struct BenchOptions {
+    size_t minProducts = 10;
+    size_t maxProducts = 10000000;
+    size_t clpMaxProducts = 100000;  // Clp simplex takes minutes per run beyond this
+    double tightness = 0.3;
+    uint64_t seed = 1;
+    std::string outputFile = "bench_results.json";
+};
+
+// One Clp algorithm on the whole model, fast path disabled
+struct ClpRun {
+    std::string name;
+    LpAlgorithm algorithm = LpAlgorithm::Auto;
+    bool presolve = false;
+    LpAlgorithm ran = LpAlgorithm::Auto;
+    double solve = -1;
+    int iterations = 0;
+    int status = -1;
+};
+
+// Fast path and Clp on the same catalog with both global rows binding
+struct BindingRun {
+    SolveResult result;
+    double solve = -1;
+    double clpSolve = -1;
+    double clpRelativeDiff = -1;
+    int bindingRows = 0;  // Global rows at a bound in the fast path solution
+};
+
+// Phase timings in milliseconds for one catalog size, negative = not run
+struct BenchRun {
+    size_t products = 0;
+    size_t repeats = 1;
+    uintmax_t configBytes = 0;
+    double generate = -1, writeConfig = -1, parse = -1, legacyParse = -1, compiledLoad = -1, validate = -1;
+    SolvePhaseTimes phases;
+    double modelBuild = -1;  // setupModel + applyConstraints + defineObjectiveFunction + loadProblem
+    double clpSolve = -1;
+    std::vector<ClpRun> clpRuns;
+    BindingRun binding;
+    SolveResult result;
+    double clpRelativeDiff = -1;
+    size_t validationIssues = 0;
+};
+
+// Largest sizes run each phase once, small ones repeat and keep the fastest
+static size_t repeatsFor(size_t count) {
+    return std::clamp<size_t>(100000 / count, 1, 50);
+}
+
+template <typename Body>
+static double timeMillis(Body body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void keepFastest(double& best, double millis) {
+    best = best < 0 ? millis : std::min(best, millis);
+}
+
+static double relativeDiff(double value, double reference) {
+    return std::abs(value - reference) / (1.0 + std::abs(reference));
+}
+
+// The blended objective drives units towards their minimum, so the generated
+// maxima leave the global rows loose at any feasible tightness. Raising the
+// budget floor and capping man-hours makes both rows bind, and the fast path
+// has to search the man-hours multiplier.
+static GlobalConstraints bindingGlobals(const ProductTable& products) {
+    GlobalConstraints globalConstraints = generateGlobals(products, 0.0);
+    globalConstraints.budgetMin += 0.7 * (globalConstraints.budgetMax - globalConstraints.budgetMin);
+    globalConstraints.manHoursMax *= 0.8;
+    return globalConstraints;
+}
+
+static BindingRun benchBinding(const ProductTable& products, const std::vector<Objective>& objectives,
+                               const BenchOptions& options) {
+    BindingRun run;
+    GlobalConstraints globalConstraints = bindingGlobals(products);
+    SolverOptions solverOptions;
+    solverOptions.verbose = false;
+    run.result = Solver(products, globalConstraints, objectives, solverOptions).solve();
+    run.solve = run.result.phases.solve;
+
+    auto atBound = [](double activity, double bound) { return relativeDiff(activity, bound) <= 1e-9; };
+    run.bindingRows = atBound(run.result.totalBudgetUsed, globalConstraints.budgetMin) +
+                      atBound(run.result.totalBudgetUsed, globalConstraints.budgetMax) +
+                      atBound(run.result.totalManHoursUsed, globalConstraints.manHoursMax);
+
+    if (products.size() <= options.clpMaxProducts) {
+        solverOptions.engine = SolverEngine::Clp;
+        SolveResult clp = Solver(products, globalConstraints, objectives, solverOptions).solve();
+        run.clpSolve = clp.phases.solve;
+        run.clpRelativeDiff = relativeDiff(run.result.objectiveValue, clp.objectiveValue);
+    }
+    return run;
+}
+
+static BenchRun benchCatalog(size_t count, const BenchOptions& options) {
+    BenchRun run;
+    run.products = count;
+    run.repeats = repeatsFor(count);
+    const std::string filename = "bench_catalog.config";
+    const std::string compiledFilename = "bench_catalog.pmm";
+
+    CatalogSpec spec;
+    spec.products = count;
+    spec.seed = options.seed;
+    spec.tightness = options.tightness;
+    ProductTable generated;
+    run.generate = timeMillis([&] { generated = generateCatalog(spec); });
+    run.writeConfig = timeMillis([&] {
+        writeInputConfig(filename, generated, generateGlobals(generated, spec.tightness), defaultObjectives());
+    });
+    generated = ProductTable();
+    run.configBytes = std::filesystem::file_size(filename);
+
+    GlobalConstraints globalConstraints{};
+    std::vector<Objective> objectives;
+    ProductTable products;
+    for (size_t r = 0; r < run.repeats; ++r) {
+        objectives.clear();
+        keepFastest(run.parse, timeMillis([&] { products = parseInputConfig(filename, globalConstraints, objectives); }));
+    }
+    if (products.size() != count) throw std::runtime_error("parse benchmark lost products");
+
+    // The unordered_map parser needs several times the memory, stop at 1M
+    if (count <= 1000000) {
+        GlobalConstraints legacyGlobals{};
+        std::vector<Objective> legacyObjectives;
+        run.legacyParse = timeMillis([&] { legacy::parseInputConfig(filename, legacyGlobals, legacyObjectives); });
+    }
+
+    writeCompiledModel(compiledFilename, products, globalConstraints, objectives);
+    run.compiledLoad = timeMillis([&] {
+        GlobalConstraints loadedGlobals{};
+        std::vector<Objective> loadedObjectives;
+        ProductTable loaded = loadCompiledModel(compiledFilename, loadedGlobals, loadedObjectives);
+        if (loaded.size() != count) throw std::runtime_error("compiled model lost products");
+    });
+    std::remove(filename.c_str());
+    std::remove(compiledFilename.c_str());
+
+    for (size_t r = 0; r < run.repeats; ++r) {
+        keepFastest(run.validate, timeMillis([&] {
+            ValidationReport report = collectValidationIssues(products, globalConstraints);
+            run.validationIssues = report.criticalCount + report.warningCount;
+        }));
+    }
+
+    SolverOptions solverOptions;
+    solverOptions.verbose = false;
+    for (size_t r = 0; r < run.repeats; ++r) {
+        Solver solver(products, globalConstraints, objectives, solverOptions);
+        SolveResult result = solver.solve();
+        if (r == 0 || result.phases.solve < run.result.phases.solve) run.result = result;
+        double* best[] = {&run.phases.setupModel, &run.phases.applyConstraints, &run.phases.defineObjective,
+                          &run.phases.solve, &run.phases.report};
+        double times[] = {result.phases.setupModel, result.phases.applyConstraints, result.phases.defineObjective,
+                          result.phases.solve, result.phases.report};
+        for (size_t k = 0; k < 5; ++k) {
+            *best[k] = r == 0 ? times[k] : std::min(*best[k], times[k]);
+        }
+    }
+
+    // The fast path never loads Clp, time the full model build on its own
+    for (size_t r = 0; r < run.repeats; ++r) {
+        Solver solver(products, globalConstraints, objectives, solverOptions);
+        keepFastest(run.modelBuild, timeMillis([&] { solver.buildModel(); }));
+    }
+
+    // Every Clp algorithm on its own, clp_solve stays primal for older result files
+    if (count <= options.clpMaxProducts) {
+        run.clpRuns = {{"primal", LpAlgorithm::Primal}, {"dual", LpAlgorithm::Dual},
+                       {"barrier", LpAlgorithm::Barrier}, {"auto", LpAlgorithm::Auto},
+                       {"auto_presolve", LpAlgorithm::Auto, true}};
+        solverOptions.engine = SolverEngine::Clp;
+        run.clpRelativeDiff = 0;
+        for (ClpRun& clpRun : run.clpRuns) {
+            solverOptions.algorithm = clpRun.algorithm;
+            solverOptions.presolve = clpRun.presolve;
+            Solver solver(products, globalConstraints, objectives, solverOptions);
+            SolveResult clp = solver.solve();
+            clpRun.ran = clp.algorithm;
+            clpRun.solve = clp.phases.solve;
+            clpRun.iterations = clp.iterations;
+            clpRun.status = clp.status;
+            run.clpRelativeDiff = std::max(run.clpRelativeDiff, relativeDiff(run.result.objectiveValue, clp.objectiveValue));
+        }
+        run.clpSolve = run.clpRuns.front().solve;
+    }
+
+    run.binding = benchBinding(products, objectives, options);
+    return run;
+}
+
+static std::string jsonMillis(double millis) {
+    return millis < 0 ? "null" : jsonNumber(millis);
+}
+
+static void writeResults(const BenchOptions& options, const std::vector<BenchRun>& runs) {
+    std::ofstream out(options.outputFile);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open benchmark output file: " + options.outputFile);
+    }
+    out << "{\n  \"seed\": " << options.seed
+        << ",\n  \"tightness\": " << jsonNumber(options.tightness)
+        << ",\n  \"hardware_threads\": " << std::thread::hardware_concurrency()
+        << ",\n  \"validation_isa\": " << jsonString(validationKernelIsa())
+        << ",\n  \"runs\": [";
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const BenchRun& run = runs[i];
+        out << (i ? "," : "") << "\n    {\"products\": " << run.products
+            << ", \"repeats\": " << run.repeats
+            << ", \"config_bytes\": " << run.configBytes
+            << ", \"status\": " << jsonString(solveStatusName(run.result.status))
+            << ", \"objective\": " << jsonNumber(run.result.objectiveValue)
+            << ", \"iterations\": " << run.result.iterations
+            << ", \"validation_issues\": " << run.validationIssues
+            << ", \"clp_relative_diff\": " << (run.clpRelativeDiff < 0 ? "null" : jsonNumber(run.clpRelativeDiff))
+            << ",\n     \"millis\": {\"generate\": " << jsonMillis(run.generate)
+            << ", \"write_config\": " << jsonMillis(run.writeConfig)
+            << ", \"parse\": " << jsonMillis(run.parse)
+            << ", \"legacy_parse\": " << jsonMillis(run.legacyParse)
+            << ", \"compiled_load\": " << jsonMillis(run.compiledLoad)
+            << ", \"validate\": " << jsonMillis(run.validate)
+            << ", \"setup_model\": " << jsonMillis(run.phases.setupModel)
+            << ", \"apply_constraints\": " << jsonMillis(run.phases.applyConstraints)
+            << ", \"define_objective\": " << jsonMillis(run.phases.defineObjective)
+            << ", \"solve\": " << jsonMillis(run.phases.solve)
+            << ", \"report\": " << jsonMillis(run.phases.report)
+            << ", \"model_build\": " << jsonMillis(run.modelBuild)
+            << ", \"clp_solve\": " << jsonMillis(run.clpSolve) << "}";
+        if (!run.clpRuns.empty()) {
+            out << ",\n     \"clp_algorithms\": {";
+            for (size_t k = 0; k < run.clpRuns.size(); ++k) {
+                const ClpRun& clpRun = run.clpRuns[k];
+                out << (k ? ", " : "") << jsonString(clpRun.name) << ": {\"ran\": "
+                    << jsonString(lpAlgorithmName(clpRun.ran)) << ", \"status\": "
+                    << jsonString(solveStatusName(clpRun.status)) << ", \"iterations\": " << clpRun.iterations
+                    << ", \"millis\": " << jsonMillis(clpRun.solve) << "}";
+            }
+            out << "}";
+        }
+        const BindingRun& binding = run.binding;
+        out << ",\n     \"binding\": {\"status\": " << jsonString(solveStatusName(binding.result.status))
+            << ", \"objective\": " << jsonNumber(binding.result.objectiveValue)
+            << ", \"binding_rows\": " << binding.bindingRows
+            << ", \"clp_relative_diff\": " << (binding.clpRelativeDiff < 0 ? "null" : jsonNumber(binding.clpRelativeDiff))
+            << ", \"millis\": {\"solve\": " << jsonMillis(binding.solve)
+            << ", \"clp_solve\": " << jsonMillis(binding.clpSolve) << "}}";
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--min-products N] [--max-products N]\n"
+              << "    [--clp-max-products N] [--tightness T] [--seed S] [--output FILE]\n"
+              << "  Times every phase on synthetic catalogs of 10, 100, ... up to 10M products, and each\n"
+              << "  Clp algorithm (primal, dual, barrier, auto, auto with presolve) up to --clp-max-products.\n"
+              << "  Each size is also solved with both global rows binding, against Clp up to the same limit\n";
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--min-products" && i + 1 < argc) {
+            options.minProducts = std::stoul(argv[++i]);
+        } else if (arg == "--max-products" && i + 1 < argc) {
+            options.maxProducts = std::stoul(argv[++i]);
+        } else if (arg == "--clp-max-products" && i + 1 < argc) {
+            options.clpMaxProducts = std::stoul(argv[++i]);
+        } else if (arg == "--tightness" && i + 1 < argc) {
+            options.tightness = std::stod(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = std::stoull(argv[++i]);
+        } else if (arg == "--output" && i + 1 < argc) {
+            options.outputFile = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::cout << std::setw(10) << "Products" << std::setw(10) << "Parse" << std::setw(10) << "Legacy"
+              << std::setw(10) << "Validate" << std::setw(10) << "Setup" << std::setw(10) << "Rows"
+              << std::setw(10) << "Objective" << std::setw(10) << "Solve" << std::setw(10) << "Report"
+              << std::setw(10) << "Build" << std::setw(10) << "Binding" << std::setw(10) << "Primal" << std::setw(10) << "Fastest" << std::setw(15) << "Clp algorithm"
+              << "   (ms)\n";
+
+    std::vector<BenchRun> runs;
+    try {
+        for (size_t count = 10; count <= options.maxProducts; count *= 10) {
+            if (count < options.minProducts) continue;
+            BenchRun run = benchCatalog(count, options);
+            auto cell = [](double millis) -> std::string {
+                if (millis < 0) return "-";
+                std::ostringstream text;
+                text << std::setprecision(4) << millis;
+                return text.str();
+            };
+            std::cout << std::setw(10) << count << std::setw(10) << cell(run.parse) << std::setw(10) << cell(run.legacyParse)
+                      << std::setw(10) << cell(run.validate) << std::setw(10) << cell(run.phases.setupModel)
+                      << std::setw(10) << cell(run.phases.applyConstraints) << std::setw(10) << cell(run.phases.defineObjective)
+                      << std::setw(10) << cell(run.phases.solve) << std::setw(10) << cell(run.phases.report)
+                      << std::setw(10) << cell(run.modelBuild) << std::setw(10) << cell(run.binding.solve)
+                      << std::setw(10) << cell(run.clpSolve);
+            auto fastest = std::min_element(run.clpRuns.begin(), run.clpRuns.end(),
+                                            [](const ClpRun& a, const ClpRun& b) { return a.solve < b.solve; });
+            if (fastest == run.clpRuns.end()) {
+                std::cout << std::setw(10) << "-" << std::setw(15) << "-" << std::endl;
+            } else {
+                std::cout << std::setw(10) << cell(fastest->solve) << std::setw(15) << fastest->name << std::endl;
+            }
+            runs.push_back(std::move(run));
+            // Write after every size so an interrupted 10M run keeps the rest
+            writeResults(options, runs);
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
+    }
+    std::cout << "Results written to " << options.outputFile << "\n";
+    return 0;
+}
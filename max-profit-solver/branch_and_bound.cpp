@@ -0,0 +1,364 @@
+#include "branch_and_bound.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+const double kIntegerTolerance = 1e-6;  // A column this close to a whole number counts as integral
+const double kFoldSlack = 1e-12;        // Relative slack for rounding errors in row / coefficient
+const double kRowTolerance = 1e-7;
+
+double roundUp(double value) {
+    return std::isfinite(value) ? std::ceil(value - kFoldSlack * std::max(1.0, std::abs(value))) : value;
+}
+
+double roundDown(double value) {
+    return std::isfinite(value) ? std::floor(value + kFoldSlack * std::max(1.0, std::abs(value))) : value;
+}
+
+double rowSlack(double bound) {
+    return kRowTolerance * std::max(1.0, std::abs(bound));
+}
+
+struct BoundChange {
+    int column;
+    double lower;
+    double upper;
+};
+
+// A subproblem waiting to be solved: the branching decisions on its path,
+// applied in order over the root bounds, and the basis of its parent
+struct Node {
+    double bound = 0.0;  // Parent's LP objective, no descendant does better
+    size_t depth = 0;
+    std::vector<BoundChange> changes;
+    std::shared_ptr<const std::vector<unsigned char>> basis;
+};
+
+// Heap order: lowest bound first, deeper nodes first on ties
+bool worseNode(const std::unique_ptr<Node>& a, const std::unique_ptr<Node>& b) {
+    if (a->bound != b->bound) return a->bound > b->bound;
+    return a->depth < b->depth;
+}
+
+class Search {
+public:
+    Search(const ClpSimplex& relaxation, const LpView& lp, const BranchAndBoundOptions& options)
+        : relaxation(relaxation), lp(lp), options(options) {}
+
+    IntegerSolution run();
+
+private:
+    const ClpSimplex& relaxation;
+    const LpView& lp;
+    const BranchAndBoundOptions& options;
+    std::vector<double> rootLower;
+    std::vector<double> rootUpper;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::unique_ptr<Node>> heap;
+    size_t active = 0;  // Nodes popped and still being solved
+    bool stopped = false;
+
+    double incumbentObjective = std::numeric_limits<double>::infinity();
+    std::vector<double> incumbent;
+    double closedBound = std::numeric_limits<double>::infinity();  // Lowest LP value of a fathomed node
+    size_t nodes = 0;
+    long iterations = 0;
+    size_t heuristicSolutions = 0;
+
+    bool foldRows();
+    double cutoff() const;
+    void offerIncumbent(const std::vector<double>& values, double objective, bool heuristic);
+    bool roundSolution(const double* values, const double* lower, const double* upper,
+                       std::vector<double>& rounded, double& objective) const;
+    void workerLoop(ClpSimplex& local);
+    void solveNode(ClpSimplex& local, std::vector<int>& touched, const Node& node,
+                   std::vector<std::unique_ptr<Node>>& children);
+};
+
+// Integer column bounds, tightened by every row with a single entry
+bool Search::foldRows() {
+    rootLower.resize(lp.numColumns);
+    rootUpper.resize(lp.numColumns);
+    std::vector<int> rowEntries(lp.numRows, 0);
+    std::vector<int> rowColumn(lp.numRows, 0);
+    std::vector<double> rowElement(lp.numRows, 0.0);
+    for (int column = 0; column < lp.numColumns; ++column) {
+        rootLower[column] = roundUp(lp.columnLower[column]);
+        rootUpper[column] = roundDown(lp.columnUpper[column]);
+        for (CoinBigIndex k = lp.columnStarts[column]; k < lp.columnStarts[column + 1]; ++k) {
+            int row = lp.rowIndices[k];
+            ++rowEntries[row];
+            rowColumn[row] = column;
+            rowElement[row] = lp.elements[k];
+        }
+    }
+    for (int row = 0; row < lp.numRows; ++row) {
+        if (rowEntries[row] != 1 || rowElement[row] == 0.0) continue;
+        double low = lp.rowLower[row] / rowElement[row];
+        double high = lp.rowUpper[row] / rowElement[row];
+        if (rowElement[row] < 0.0) std::swap(low, high);
+        int column = rowColumn[row];
+        rootLower[column] = std::max(rootLower[column], roundUp(low));
+        rootUpper[column] = std::min(rootUpper[column], roundDown(high));
+    }
+    for (int column = 0; column < lp.numColumns; ++column) {
+        if (rootLower[column] > rootUpper[column]) return false;
+    }
+    return true;
+}
+
+double Search::cutoff() const {
+    return incumbentObjective - std::max(options.relativeGap * std::abs(incumbentObjective), 1e-9);
+}
+
+void Search::offerIncumbent(const std::vector<double>& values, double objective, bool heuristic) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (objective < incumbentObjective) {
+        incumbentObjective = objective;
+        incumbent = values;
+        heuristicSolutions += heuristic;
+    }
+}
+
+// Round an LP solution down to whole units, then round columns back up,
+// cheapest objective first, where that repairs a row left below its lower
+// bound (the global budget minimum) or improves the objective without
+// pushing any row past its limits. Budget and man-hour entries are all
+// positive, so rounding down alone keeps every upper limit.
+bool Search::roundSolution(const double* values, const double* lower, const double* upper,
+                           std::vector<double>& rounded, double& objective) const {
+    std::vector<double> activity(lp.numRows, 0.0);
+    std::vector<int> fractional;
+    rounded.resize(lp.numColumns);
+    for (int column = 0; column < lp.numColumns; ++column) {
+        double value = std::floor(values[column] + kIntegerTolerance);
+        if (values[column] - value > kIntegerTolerance) fractional.push_back(column);
+        rounded[column] = std::min(std::max(value, lower[column]), upper[column]);
+        for (CoinBigIndex k = lp.columnStarts[column]; k < lp.columnStarts[column + 1]; ++k) {
+            activity[lp.rowIndices[k]] += lp.elements[k] * rounded[column];
+        }
+    }
+
+    std::sort(fractional.begin(), fractional.end(),
+              [&](int a, int b) { return lp.objective[a] < lp.objective[b]; });
+    for (int column : fractional) {
+        if (rounded[column] + 1.0 > upper[column]) continue;
+        bool helps = lp.objective[column] < 0.0;
+        bool fits = true;
+        for (CoinBigIndex k = lp.columnStarts[column]; k < lp.columnStarts[column + 1] && fits; ++k) {
+            int row = lp.rowIndices[k];
+            double next = activity[row] + lp.elements[k];
+            bool below = activity[row] < lp.rowLower[row] - rowSlack(lp.rowLower[row]);
+            helps = helps || (below && lp.elements[k] > 0.0);
+            fits = next <= lp.rowUpper[row] + rowSlack(lp.rowUpper[row]) &&
+                   (below || next >= lp.rowLower[row] - rowSlack(lp.rowLower[row]));
+        }
+        if (!helps || !fits) continue;
+        rounded[column] += 1.0;
+        for (CoinBigIndex k = lp.columnStarts[column]; k < lp.columnStarts[column + 1]; ++k) {
+            activity[lp.rowIndices[k]] += lp.elements[k];
+        }
+    }
+
+    for (int row = 0; row < lp.numRows; ++row) {
+        if (activity[row] < lp.rowLower[row] - rowSlack(lp.rowLower[row]) ||
+            activity[row] > lp.rowUpper[row] + rowSlack(lp.rowUpper[row])) {
+            return false;
+        }
+    }
+    objective = 0.0;
+    for (int column = 0; column < lp.numColumns; ++column) {
+        objective += lp.objective[column] * rounded[column];
+    }
+    return true;
+}
+
+void Search::solveNode(ClpSimplex& local, std::vector<int>& touched, const Node& node,
+                       std::vector<std::unique_ptr<Node>>& children) {
+    // Back to the root bounds, then down the node's path
+    for (int column : touched) {
+        local.setColumnBounds(column, rootLower[column], rootUpper[column]);
+    }
+    touched.clear();
+    for (const BoundChange& change : node.changes) {
+        local.setColumnBounds(change.column, change.lower, change.upper);
+        touched.push_back(change.column);
+    }
+
+    // Only bounds differ from the parent, so its basis stays dual feasible
+    local.copyinStatus(node.basis->data());
+    runLpAlgorithm(local, options.algorithm, WarmStart::Bounds, false);
+    double objective = local.objectiveValue();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++nodes;
+        iterations += local.numberIterations();
+        if (local.status() == 1) return;
+        if (local.status() != 0 || objective >= cutoff()) {
+            // Not solved to optimality: keep the parent's bound so the final gap stays honest
+            closedBound = std::min(closedBound, local.status() == 0 ? objective : node.bound);
+            return;
+        }
+    }
+
+    const double* values = local.getColSolution();
+    int branchColumn = -1;
+    double mostFractional = 0.0;
+    for (int column = 0; column < lp.numColumns; ++column) {
+        double fraction = values[column] - std::floor(values[column]);
+        double distance = std::min(fraction, 1.0 - fraction);
+        if (distance > kIntegerTolerance && distance > mostFractional) {
+            mostFractional = distance;
+            branchColumn = column;
+        }
+    }
+
+    std::vector<double> rounded;
+    if (branchColumn < 0) {
+        for (int column = 0; column < lp.numColumns; ++column) {
+            rounded.push_back(std::round(values[column]));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        closedBound = std::min(closedBound, objective);
+        if (objective < incumbentObjective) {
+            incumbentObjective = objective;
+            incumbent = std::move(rounded);
+        }
+        return;
+    }
+
+    double roundedObjective = 0.0;
+    if (roundSolution(values, local.getColLower(), local.getColUpper(), rounded, roundedObjective)) {
+        offerIncumbent(rounded, roundedObjective, true);
+    }
+
+    auto basis = std::make_shared<const std::vector<unsigned char>>(
+        local.statusArray(), local.statusArray() + local.numberRows() + local.numberColumns());
+    double value = values[branchColumn];
+    double lower = local.getColLower()[branchColumn];
+    double upper = local.getColUpper()[branchColumn];
+    for (int side = 0; side < 2; ++side) {
+        auto child = std::make_unique<Node>();
+        child->bound = objective;
+        child->depth = node.depth + 1;
+        child->changes = node.changes;
+        child->changes.push_back(side == 0 ? BoundChange{branchColumn, lower, std::floor(value)}
+                                           : BoundChange{branchColumn, std::ceil(value), upper});
+        child->basis = basis;
+        children.push_back(std::move(child));
+    }
+}
+
+void Search::workerLoop(ClpSimplex& local) {
+    std::vector<int> touched;
+    std::vector<std::unique_ptr<Node>> children;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [&] { return !heap.empty() || active == 0 || stopped; });
+        if (stopped || heap.empty()) break;
+        if (nodes >= options.maxNodes) {
+            stopped = true;
+            changed.notify_all();
+            break;
+        }
+        std::pop_heap(heap.begin(), heap.end(), worseNode);
+        std::unique_ptr<Node> node = std::move(heap.back());
+        heap.pop_back();
+        if (node->bound >= cutoff()) {
+            closedBound = std::min(closedBound, node->bound);
+            changed.notify_all();
+            continue;
+        }
+
+        ++active;
+        lock.unlock();
+        solveNode(local, touched, *node, children);
+        lock.lock();
+        --active;
+        for (auto& child : children) {
+            heap.push_back(std::move(child));
+            std::push_heap(heap.begin(), heap.end(), worseNode);
+        }
+        children.clear();
+        changed.notify_all();
+    }
+}
+
+IntegerSolution Search::run() {
+    IntegerSolution solution;
+    if (relaxation.numberRows() != lp.numRows || relaxation.numberColumns() != lp.numColumns) {
+        throw std::invalid_argument("Integer units need the plain model without added rows");
+    }
+    if (!foldRows()) {
+        return solution;
+    }
+
+    auto root = std::make_unique<Node>();
+    root->bound = relaxation.objectiveValue();
+    root->basis = std::make_shared<const std::vector<unsigned char>>(
+        relaxation.statusArray(), relaxation.statusArray() + lp.numRows + lp.numColumns);
+    heap.push_back(std::move(root));
+
+    // One copy of the relaxation per worker, over the folded integer bounds
+    auto makeModel = [&] {
+        auto local = std::make_unique<ClpSimplex>(relaxation);
+        local->setLogLevel(0);
+        for (int column = 0; column < lp.numColumns; ++column) {
+            local->setColumnBounds(column, rootLower[column], rootUpper[column]);
+        }
+        return local;
+    };
+    if (options.threads == 1 || ThreadPool::currentWorker() >= 0) {
+        // Already on a pool worker (batch runs): search on this thread
+        auto local = makeModel();
+        workerLoop(*local);
+    } else {
+        ThreadPool pool(options.threads);
+        std::vector<std::unique_ptr<ClpSimplex>> workerModels;
+        for (unsigned worker = 0; worker < pool.size(); ++worker) {
+            workerModels.push_back(makeModel());
+        }
+        pool.parallelFor(pool.size(), [&](size_t) { workerLoop(*workerModels[ThreadPool::currentWorker()]); });
+    }
+
+    solution.nodes = nodes;
+    solution.iterations = iterations;
+    solution.heuristicSolutions = heuristicSolutions;
+    solution.bound = std::min(closedBound, incumbentObjective);
+    for (const auto& node : heap) {
+        solution.bound = std::min(solution.bound, node->bound);
+    }
+    if (!incumbent.empty()) {
+        solution.objectiveValue = incumbentObjective;
+        solution.columnValues = std::move(incumbent);
+        solution.outcome = stopped ? IntegerSolution::NodeLimit : IntegerSolution::Optimal;
+    } else {
+        solution.outcome = stopped ? IntegerSolution::NodeLimit : IntegerSolution::Infeasible;
+    }
+    return solution;
+}
+
+} // namespace
+
+const char* integerOutcomeName(IntegerSolution::Outcome outcome) {
+    switch (outcome) {
+        case IntegerSolution::Optimal: return "optimal";
+        case IntegerSolution::NodeLimit: return "node_limit";
+        default: return "infeasible";
+    }
+}
+
+IntegerSolution solveIntegerUnits(const ClpSimplex& relaxation, const LpView& lp,
+                                  const BranchAndBoundOptions& options) {
+    Search search(relaxation, lp, options);
+    return search.run();
+}
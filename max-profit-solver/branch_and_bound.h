@@ -0,0 +1,41 @@
+// branch_and_bound.h
+#ifndef BRANCH_AND_BOUND_H
+#define BRANCH_AND_BOUND_H
+
+#include "lp_algorithm.h"
+#include "structured_solver.h"
+#include <cstddef>
+#include <vector>
+#include <ClpSimplex.hpp>
+
+struct BranchAndBoundOptions {
+    double relativeGap = 1e-4;  // Stop once the incumbent is this close to the best bound
+    size_t maxNodes = 100000;   // Node LPs solved before giving up on proving the gap
+    unsigned threads = 0;       // Worker threads, 0 = all cores
+    LpAlgorithm algorithm = LpAlgorithm::Auto;
+};
+
+struct IntegerSolution {
+    enum Outcome { Optimal, NodeLimit, Infeasible };
+    Outcome outcome = Infeasible;
+    double objectiveValue = 0.0;     // Of the incumbent, valid when columnValues is not empty
+    double bound = 0.0;              // Lowest objective any integer solution can reach
+    std::vector<double> columnValues;
+    size_t nodes = 0;
+    long iterations = 0;
+    size_t heuristicSolutions = 0;   // Incumbents found by rounding rather than at a leaf
+};
+
+const char* integerOutcomeName(IntegerSolution::Outcome outcome);
+
+// Minimize over whole units of every column. `relaxation` holds the loaded
+// LP with an optimal basis and `lp` the same model's arrays; rows beyond
+// lp.numRows are not allowed. Rows with a single entry are folded into
+// integer column bounds first, so product budget and man-hour rows never
+// need branching. Nodes are solved best bound first on per-thread copies of
+// the model, each with dual simplex from its parent's basis, and every node
+// tries rounding its LP solution into an incumbent.
+IntegerSolution solveIntegerUnits(const ClpSimplex& relaxation, const LpView& lp,
+                                  const BranchAndBoundOptions& options);
+
+#endif // BRANCH_AND_BOUND_H
@@ -83,17 +83,34 @@ fi
 # Create Makefile
 cat <<EOF > Makefile
 CXX = g++
-CXXFLAGS = -std=c++17 -Wall -O2 -I${CLP_INCLUDE_PATH} -I${COINUTILS_INCLUDE_PATH}
+CXXFLAGS = -std=c++17 -Wall -O2 -pthread -I${CLP_INCLUDE_PATH} -I${COINUTILS_INCLUDE_PATH}
 LIBS = -L${CLP_LIB_PATH} -L${COINUTILS_LIB_PATH} -L${OSI_LIB_PATH} -lClp -lOsiClp -lOsi -lm
 
 TARGET = profit_maximizer
-SOURCES = profit_maximizer.cpp input.cpp solver.cpp
+COMMON_SOURCES = input.cpp solver.cpp batch.cpp thread_pool.cpp json_util.cpp mapped_file.cpp model_file.cpp sensitivity_report.cpp parametric.cpp server.cpp structured_solver.cpp product_table.cpp validation_kernels.cpp catalog_generator.cpp metrics.cpp result_writer.cpp solution_cache.cpp lp_algorithm.cpp monte_carlo.cpp branch_and_bound.cpp site_decomposition.cpp rolling_horizon.cpp
+SOURCES = profit_maximizer.cpp \$(COMMON_SOURCES)
+
+BENCH_TARGET = profit_bench
+BENCH_SOURCES = bench.cpp \$(COMMON_SOURCES)
+
+TEST_TARGET = profit_tests
+TEST_SOURCES = test_main.cpp input_test.cpp model_file_test.cpp structured_solver_test.cpp solution_cache_test.cpp \$(COMMON_SOURCES)
+
+.PHONY: all bench test clean
 
 all: 
 	\$(CXX) \$(CXXFLAGS) \$(SOURCES) -o \$(TARGET) \$(LIBS)
 
+bench:
+	\$(CXX) \$(CXXFLAGS) \$(BENCH_SOURCES) -o \$(BENCH_TARGET) \$(LIBS)
+	./\$(BENCH_TARGET) \$(BENCH_ARGS)
+
+test:
+	\$(CXX) \$(CXXFLAGS) \$(TEST_SOURCES) -o \$(TEST_TARGET) \$(LIBS)
+	./\$(TEST_TARGET)
+
 clean:
-	rm -f \$(TARGET)
+	rm -f \$(TARGET) \$(BENCH_TARGET) \$(TEST_TARGET)
 EOF
 
 echo "Makefile created."
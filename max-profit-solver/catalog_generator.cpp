@@ -0,0 +1,186 @@
+#include "catalog_generator.h"
+#include "validation_kernels.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+// splitmix64, small and identical everywhere unlike std:: distributions
+class CatalogRandom {
+public:
+    explicit CatalogRandom(uint64_t seed) : state(seed) {}
+
+    double uniform(double lo, double hi) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        return lo + (hi - lo) * static_cast<double>(z >> 11) / 9007199254740992.0;
+    }
+
+private:
+    uint64_t state;
+};
+
+// Buffered text output with to_chars formatting
+class ConfigWriter {
+public:
+    explicit ConfigWriter(const std::string& filename) : out(filename, std::ios::binary), filename(filename) {
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open config file for writing: " + filename);
+        }
+        buffer.reserve(kFlushSize + 256);
+    }
+
+    ConfigWriter& operator<<(const std::string& text) {
+        buffer += text;
+        return flushIfFull();
+    }
+
+    ConfigWriter& operator<<(const char* text) {
+        buffer += text;
+        return flushIfFull();
+    }
+
+    ConfigWriter& operator<<(double value) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+        return flushIfFull();
+    }
+
+    ConfigWriter& operator<<(size_t value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+        return flushIfFull();
+    }
+
+    ConfigWriter& range(double min, double max) {
+        return *this << min << ", " << max << "\n";
+    }
+
+    void close() {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+        out.close();
+        if (!out) {
+            throw std::runtime_error("Failed to write config file: " + filename);
+        }
+    }
+
+private:
+    static const size_t kFlushSize = 1 << 20;
+    std::ofstream out;
+    std::string filename;
+    std::string buffer;
+
+    ConfigWriter& flushIfFull() {
+        if (buffer.size() >= kFlushSize) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+        return *this;
+    }
+};
+
+} // namespace
+
+ProductTable generateCatalog(const CatalogSpec& spec) {
+    ProductTable products;
+    products.reserve(spec.products);
+    CatalogRandom random(spec.seed);
+
+    for (size_t i = 0; i < spec.products; ++i) {
+        Product product{};
+        product.name = "P" + std::to_string(i);
+        product.costMin = random.uniform(10, 100);
+        product.costMax = product.costMin * random.uniform(1.05, 1.2);
+        product.profitMin = random.uniform(5, 15);
+        product.profitMax = product.profitMin + random.uniform(1, 5);
+        product.demandMin = random.uniform(10, 100);
+        product.demandMax = product.demandMin * random.uniform(1.2, 2.0);
+        // Exactly the realistic ranges, so validation raises no product warnings
+        product.budgetMin = product.costMin * product.demandMin;
+        product.budgetMax = product.costMax * product.demandMax;
+        product.manHourPerUnitMin = random.uniform(0.5, 3);
+        product.manHourPerUnitMax = product.manHourPerUnitMin + random.uniform(0.1, 1);
+        product.totalManHoursMin = 0.0;
+        product.totalManHoursMax = product.manHourPerUnitMax * product.demandMax;
+        products.insertOrAssign(product);
+    }
+    return products;
+}
+
+GlobalConstraints generateGlobals(const ProductTable& products, double tightness) {
+    if (tightness < 0.0 || tightness > 1.0) {
+        throw std::invalid_argument("Tightness must be between 0 and 1");
+    }
+    const auto& demandMin = products.column(&Product::demandMin);
+    const auto& demandMax = products.column(&Product::demandMax);
+    const auto& manHourPerUnitMin = products.column(&Product::manHourPerUnitMin);
+    const auto& manHourPerUnitMax = products.column(&Product::manHourPerUnitMax);
+
+    // Budget totals from the validation kernel itself, a sum in another
+    // order can land an ulp outside the realistic range it checks
+    RangeViolations ranges = checkProductRanges(products);
+    double minBudget = ranges.totalMinBudget, maxBudget = ranges.totalMaxBudget;
+    double minManHours = 0.0, maxManHours = 0.0;
+    for (size_t i = 0; i < products.size(); ++i) {
+        minManHours += manHourPerUnitMin[i] * demandMin[i];
+        maxManHours += manHourPerUnitMax[i] * demandMax[i];
+    }
+
+    GlobalConstraints globalConstraints{};
+    globalConstraints.budgetMin = minBudget;
+    globalConstraints.budgetMax = maxBudget - tightness * (maxBudget - minBudget);
+    globalConstraints.profitMin = 0.0;
+    globalConstraints.profitMax = 100.0;
+    globalConstraints.manHoursMin = 0.0;
+    globalConstraints.manHoursMax = maxManHours - tightness * (maxManHours - minManHours);
+    return globalConstraints;
+}
+
+std::vector<Objective> defaultObjectives() {
+    return {{"profit", "maximize", 1}, {"resource_usage", "minimize", 2}, {"budget_usage", "maximize", 3}};
+}
+
+void writeInputConfig(const std::string& filename,
+                      const ProductTable& products,
+                      const GlobalConstraints& globalConstraints,
+                      const std::vector<Objective>& objectives) {
+    ConfigWriter out(filename);
+    for (size_t i = 0; i < products.size(); ++i) {
+        Product product = products.get(i);
+        out << "[Product" << i + 1 << "]\n"
+            << "product_name = " << product.name << "\n";
+        out << "cost_range = ";
+        out.range(product.costMin, product.costMax);
+        out << "profit_range = ";
+        out.range(product.profitMin, product.profitMax);
+        out << "demand_range = ";
+        out.range(product.demandMin, product.demandMax);
+        out << "budget_range = ";
+        out.range(product.budgetMin, product.budgetMax);
+        out << "man_hour_per_unit = ";
+        out.range(product.manHourPerUnitMin, product.manHourPerUnitMax);
+        out << "total_man_hours = ";
+        out.range(product.totalManHoursMin, product.totalManHoursMax);
+        out << "\n";
+    }
+
+    out << "[Global]\nglobal_budget = ";
+    out.range(globalConstraints.budgetMin, globalConstraints.budgetMax);
+    out << "global_profit = ";
+    out.range(globalConstraints.profitMin, globalConstraints.profitMax);
+    out << "global_man_hours = ";
+    out.range(globalConstraints.manHoursMin, globalConstraints.manHoursMax);
+
+    out << "\n[Objectives]\n";
+    for (const Objective& objective : objectives) {
+        out << objective.type << "_" << objective.name << " = " << static_cast<size_t>(objective.rank) << "\n";
+    }
+    out.close();
+}
@@ -0,0 +1,37 @@
+// catalog_generator.h
+#ifndef CATALOG_GENERATOR_H
+#define CATALOG_GENERATOR_H
+
+#include "input.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Synthetic catalog description. The same spec always yields the same
+// products, on every platform.
+struct CatalogSpec {
+    size_t products = 1000;
+    uint64_t seed = 1;
+    // Share of the slack between the realistic minimum and maximum global
+    // budget and man-hours that is taken away: 0 leaves the global rows
+    // loose, 1 leaves no room at all (usually infeasible).
+    double tightness = 0.3;
+};
+
+// Products named P0..P{n-1} whose own ranges pass validation unchanged
+ProductTable generateCatalog(const CatalogSpec& spec);
+
+// Global ranges for a catalog at the given tightness
+GlobalConstraints generateGlobals(const ProductTable& products, double tightness);
+
+// Profit first, then resource usage, then budget usage
+std::vector<Objective> defaultObjectives();
+
+// Write an input.config; numbers use the shortest exact form so parsing the
+// file gives back the same doubles
+void writeInputConfig(const std::string& filename,
+                      const ProductTable& products,
+                      const GlobalConstraints& globalConstraints,
+                      const std::vector<Objective>& objectives);
+
+#endif // CATALOG_GENERATOR_H
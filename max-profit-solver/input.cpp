@@ -1,187 +1,480 @@
 #include "input.h"
+#include "mapped_file.h"
+#include "metrics.h"
+#include "validation_kernels.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <algorithm>
+#include <iterator>
+#include <cctype>
+#include <cmath>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
 #include <vector>
 #include <string>
 
+// Relative slack when comparing the global budget with the summed product ranges
+static const double kGlobalBudgetTolerance = 1e-9;
+
 // Helper to trim spaces
-std::string trim(const std::string& str) {
+static std::string_view trim(std::string_view str) {
     size_t start = str.find_first_not_of(" \t");
     size_t end = str.find_last_not_of(" \t");
-    return (start == std::string::npos || end == std::string::npos) ? "" : str.substr(start, end - start + 1);
+    return (start == std::string_view::npos || end == std::string_view::npos) ? std::string_view() : str.substr(start, end - start + 1);
+}
+
+// std::stod semantics on a slice: leading whitespace and '+' allowed,
+// trailing characters ignored, failures reported as "stod"
+static double parseDouble(std::string_view text) {
+    size_t pos = 0;
+    while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+    if (pos < text.size() && text[pos] == '+') ++pos;
+
+    double value = 0.0;
+    auto [ptr, ec] = std::from_chars(text.data() + pos, text.data() + text.size(), value);
+    if (ec == std::errc::invalid_argument) throw std::invalid_argument("stod");
+    if (ec == std::errc::result_out_of_range) throw std::out_of_range("stod");
+    return value;
+}
+
+// std::stoi semantics on a slice
+static int parseInt(std::string_view text) {
+    size_t pos = 0;
+    while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+    if (pos < text.size() && text[pos] == '+') ++pos;
+
+    int value = 0;
+    auto [ptr, ec] = std::from_chars(text.data() + pos, text.data() + text.size(), value);
+    if (ec == std::errc::invalid_argument) throw std::invalid_argument("stoi");
+    if (ec == std::errc::result_out_of_range) throw std::out_of_range("stoi");
+    return value;
+}
+
+// Helper to split a range value: "min, max", anything after a second comma is ignored
+static std::pair<double, double> parseRange(std::string_view value) {
+    size_t firstComma = value.find(',');
+    if (firstComma != std::string_view::npos && firstComma + 1 < value.size()) {
+        std::string_view min = value.substr(0, firstComma);
+        std::string_view max = value.substr(firstComma + 1);
+        max = max.substr(0, max.find(','));
+        return {parseDouble(trim(min)), parseDouble(trim(max))};
+    }
+    throw std::invalid_argument("Invalid range format: " + std::string(value));
 }
 
-// Helper to split a range value
-std::pair<double, double> parseRange(const std::string& value) {
-    std::istringstream ss(value);
-    std::string min, max;
-    if (std::getline(ss, min, ',') && std::getline(ss, max, ',')) {
-        return {std::stod(trim(min)), std::stod(trim(max))};
+// Index of the range minimum in kProductFields for a product range key,
+// npos for any other key
+static size_t productRangeField(std::string_view key) {
+    static constexpr std::string_view keys[] = {
+        "cost_range", "profit_range", "demand_range", "budget_range", "man_hour_per_unit", "total_man_hours"};
+    for (size_t i = 0; i < std::size(keys); ++i) {
+        if (key == keys[i]) return 2 * i;
+    }
+    return ProductTable::npos;
+}
+
+// Split a time-indexed key "key@PERIOD", period 0 for a plain key. Only an
+// '@' followed by digits marks a period, any other key is returned whole.
+static std::pair<std::string_view, uint32_t> splitPeriod(std::string_view key, std::string_view section) {
+    size_t at = key.find('@');
+    if (at == std::string_view::npos) return {key, 0};
+    std::string_view digits = key.substr(at + 1);
+    if (digits.empty() || !std::all_of(digits.begin(), digits.end(),
+                                       [](unsigned char c) { return std::isdigit(c); })) {
+        return {key, 0};
+    }
+    uint32_t period = 0;
+    auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), period);
+    if (ec != std::errc() || period < 1) {
+        throw std::invalid_argument("Invalid period in [" + std::string(section) + "] key: " + std::string(key));
     }
-    throw std::invalid_argument("Invalid range format: " + value);
+    return {trim(key.substr(0, at)), period};
 }
 
-// Parse the input config
-std::unordered_map<std::string, Product> parseInputConfig(const std::string& filename, GlobalConstraints& globalConstraints, std::vector<Objective>& objectives) {
-    std::unordered_map<std::string, Product> products;
-    std::ifstream file(filename);
+// Helper to split a comma separated list of numbers
+static std::vector<double> parseList(std::string_view value) {
+    std::vector<double> values;
+    while (true) {
+        size_t comma = value.find(',');
+        values.push_back(parseDouble(trim(value.substr(0, comma))));
+        if (comma == std::string_view::npos) break;
+        value = value.substr(comma + 1);
+    }
+    return values;
+}
+
+ProductTable parseInputConfig(const std::string& filename, GlobalConstraints& globalConstraints, std::vector<Objective>& objectives) {
+    SensitivityConfig sensitivity;
+    return parseInputConfig(filename, globalConstraints, objectives, sensitivity);
+}
 
-    if (!file.is_open()) {
+ProductTable parseInputConfig(const std::string& filename, GlobalConstraints& globalConstraints, std::vector<Objective>& objectives, SensitivityConfig& sensitivity) {
+    SiteConfig sites;
+    HorizonConfig horizon;
+    ProductTable products = parseInputConfig(filename, globalConstraints, objectives, sensitivity, sites, horizon);
+    if (!sites.empty()) {
+        throw std::invalid_argument("Multi-site configs can only be solved directly, not here: " + filename);
+    }
+    if (!horizon.empty()) {
+        throw std::invalid_argument("Multi-period configs can only be solved directly, not here: " + filename);
+    }
+    return products;
+}
+
+// Parse the input config. The file is memory-mapped and scanned in place:
+// keys and values are slices of the mapping, only product, objective and site
+// names are copied out.
+ProductTable parseInputConfig(const std::string& filename, GlobalConstraints& globalConstraints, std::vector<Objective>& objectives, SensitivityConfig& sensitivity, SiteConfig& sites, HorizonConfig& horizon) {
+    PhaseTimer timer(MetricsPhase::Parse);
+    ProductTable products;
+    MappedFile file;
+
+    if (!file.open(filename)) {
         throw std::runtime_error("Failed to open input file: " + filename);
     }
 
-    std::string line, currentSection;
+    enum class Section { None, Product, Global, Objectives, Sensitivity, Site, Horizon };
+    Section section = Section::None;
     Product currentProduct;
-    while (std::getline(file, line)) {
-        line = trim(line);
+    std::vector<double> currentProfitDeltas;
+    const uint32_t noSite = std::numeric_limits<uint32_t>::max();
+    uint32_t currentSite = noSite;
+    std::string_view sectionName;  // For messages, a slice of the mapping
+    std::vector<ProductChange> currentChanges;
+    // Inventory keys of the current product, stored per product once any product has one
+    double currentStock[4] = {0.0, 0.0, 0.0, 0.0};
+    bool stockSeen = false;
+    std::vector<double>* stockColumns[4] = {&horizon.inventoryMin, &horizon.inventoryMax, &horizon.holdingCost,
+                                            &horizon.initialInventory};
+
+    auto siteIndex = [&](std::string_view name) {
+        for (size_t i = 0; i < sites.sites.size(); ++i) {
+            if (sites.sites[i].name == name) return static_cast<uint32_t>(i);
+        }
+        sites.sites.push_back(SiteLimits{});
+        sites.sites.back().name = name;
+        return static_cast<uint32_t>(sites.sites.size() - 1);
+    };
+
+    auto finishProduct = [&]() {
+        if (!currentProfitDeltas.empty()) {
+            sensitivity.productProfitDeltas[currentProduct.name] = std::move(currentProfitDeltas);
+            currentProfitDeltas.clear();
+        }
+        size_t existing = products.size();
+        size_t index = products.insertOrAssign(currentProduct);
+        sites.productSite.resize(products.size(), noSite);
+        sites.productSite[index] = currentSite;
+
+        // A repeated product drops the changes of its earlier entry
+        auto& changes = horizon.productChanges;
+        if (index < existing && !changes.empty()) {
+            changes.erase(std::remove_if(changes.begin(), changes.end(),
+                                         [&](const ProductChange& change) { return change.product == index; }),
+                          changes.end());
+        }
+        for (ProductChange& change : currentChanges) {
+            change.product = static_cast<uint32_t>(index);
+            changes.push_back(change);
+        }
+        currentChanges.clear();
+        if (stockSeen) {
+            for (size_t k = 0; k < 4; ++k) {
+                stockColumns[k]->resize(products.size(), 0.0);
+                (*stockColumns[k])[index] = currentStock[k];
+                currentStock[k] = 0.0;
+            }
+        }
+    };
+
+    std::string_view text = file.view();
+    size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) lineEnd = text.size();
+        std::string_view line = trim(text.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+
         if (line.empty() || line[0] == '#') continue; // Skip empty lines and comments
 
         if (line[0] == '[' && line.back() == ']') {
             // New section
-            if (!currentSection.empty() && currentSection != "Global" && currentSection != "Objectives") {
-                products[currentProduct.name] = currentProduct;
+            if (section == Section::Product) {
+                finishProduct();
             }
-            currentSection = line.substr(1, line.size() - 2);
-            if (currentSection != "Global" && currentSection != "Objectives") {
+            std::string_view name = line.substr(1, line.size() - 2);
+            sectionName = name;
+            if (name.empty()) {
+                section = Section::None;
                 currentProduct = Product{};
+            } else if (name == "Global") {
+                section = Section::Global;
+            } else if (name == "Objectives") {
+                section = Section::Objectives;
+            } else if (name == "Sensitivity") {
+                section = Section::Sensitivity;
+            } else if (name == "Horizon") {
+                section = Section::Horizon;
+            } else if (name.substr(0, 5) == "Site:") {
+                section = Section::Site;
+                currentSite = siteIndex(trim(name.substr(5)));
+            } else {
+                section = Section::Product;
+                currentProduct = Product{};
+                currentProfitDeltas.clear();
+                currentSite = noSite;
+                currentChanges.clear();
+                std::fill(std::begin(currentStock), std::end(currentStock), 0.0);
             }
             continue;
         }
 
         size_t delimiterPos = line.find('=');
-        if (delimiterPos == std::string::npos) {
-            throw std::invalid_argument("Invalid config line: " + line);
+        if (delimiterPos == std::string_view::npos) {
+            throw std::invalid_argument("Invalid config line: " + std::string(line));
         }
 
-        std::string key = trim(line.substr(0, delimiterPos));
-        std::string value = trim(line.substr(delimiterPos + 1));
+        std::string_view key = trim(line.substr(0, delimiterPos));
+        std::string_view value = trim(line.substr(delimiterPos + 1));
 
-        // Parse global constraints
-        if (currentSection == "Global") {
-            if (key == "global_budget") {
+        // Parse sensitivity analysis grids
+        if (section == Section::Sensitivity) {
+            if (key == "profit_deltas") {
+                sensitivity.profitDeltas = parseList(value);
+            } else if (key == "global_budget_deltas") {
+                sensitivity.budgetDeltas = parseList(value);
+            } else if (key == "global_man_hours_deltas") {
+                sensitivity.manHoursDeltas = parseList(value);
+            }
+        } else if (section == Section::Site) {
+            // Plant-level limits, the man-hours minimum is ignored as for global_man_hours
+            SiteLimits& site = sites.sites[currentSite];
+            if (key == "site_budget") {
+                std::tie(site.budgetMin, site.budgetMax) = parseRange(value);
+            } else if (key == "site_man_hours") {
+                site.manHoursMax = parseRange(value).second;
+            }
+        } else if (section == Section::Horizon) {
+            int count = parseInt(value);
+            if (count < 1) {
+                throw std::invalid_argument("Invalid [Horizon] value: " + std::string(line));
+            }
+            if (key == "periods") {
+                horizon.periods = static_cast<size_t>(count);
+            } else if (key == "window") {
+                horizon.window = static_cast<size_t>(count);
+            } else if (key == "step") {
+                horizon.step = static_cast<size_t>(count);
+            }
+        } else if (section == Section::Global) {
+            // Parse global constraints, "key@PERIOD" changes a range from that period on
+            auto [name, period] = splitPeriod(key, sectionName);
+            if (period > 0) {
+                auto [min, max] = parseRange(value);
+                if (name == "global_budget") {
+                    horizon.globalChanges.push_back({period, &GlobalConstraints::budgetMin, &GlobalConstraints::budgetMax, min, max});
+                } else if (name == "global_man_hours") {
+                    horizon.globalChanges.push_back({period, &GlobalConstraints::manHoursMin, &GlobalConstraints::manHoursMax, min, max});
+                }
+            } else if (key == "global_budget") {
                 std::tie(globalConstraints.budgetMin, globalConstraints.budgetMax) = parseRange(value);
             } else if (key == "global_profit") {
                 std::tie(globalConstraints.profitMin, globalConstraints.profitMax) = parseRange(value);
             } else if (key == "global_man_hours") {
                 std::tie(globalConstraints.manHoursMin, globalConstraints.manHoursMax) = parseRange(value);
             }
-        } else if (currentSection == "Objectives") {
+        } else if (section == Section::Objectives) {
             // Parse objectives
             size_t spacePos = key.find('_');
-            if (spacePos == std::string::npos) {
-                throw std::invalid_argument("Invalid objective key: " + key);
+            if (spacePos == std::string_view::npos) {
+                throw std::invalid_argument("Invalid objective key: " + std::string(key));
             }
 
-            std::string type = key.substr(0, spacePos);
-            std::string name = key.substr(spacePos + 1);
+            std::string_view type = key.substr(0, spacePos);
+            std::string_view name = key.substr(spacePos + 1);
 
             if (type != "maximize" && type != "minimize") {
-                throw std::invalid_argument("Invalid objective type: " + type);
+                throw std::invalid_argument("Invalid objective type: " + std::string(type));
             }
-            auto rank_value = std::stoi(value);
-            objectives.push_back({name, type, rank_value > 10 ? 10 : rank_value});
+            auto rank_value = parseInt(value);
+            objectives.push_back({std::string(name), std::string(type), rank_value > 10 ? 10 : rank_value});
         } else {
-            // Parse product constraints
-            if (key == "product_name") {
+            // Parse product constraints, "key@PERIOD" changes a range from that period on
+            auto [name, period] = splitPeriod(key, sectionName);
+            size_t field = productRangeField(name);
+            if (field != ProductTable::npos) {
+                auto [min, max] = parseRange(value);
+                if (period > 0) {
+                    currentChanges.push_back({period, 0, static_cast<uint32_t>(field), min, max});
+                } else {
+                    currentProduct.*kProductFields[field] = min;
+                    currentProduct.*kProductFields[field + 1] = max;
+                }
+            } else if (key == "product_name") {
                 currentProduct.name = value;
-            } else if (key == "cost_range") {
-                std::tie(currentProduct.costMin, currentProduct.costMax) = parseRange(value);
-            } else if (key == "profit_range") {
-                std::tie(currentProduct.profitMin, currentProduct.profitMax) = parseRange(value);
-            } else if (key == "demand_range") {
-                std::tie(currentProduct.demandMin, currentProduct.demandMax) = parseRange(value);
-            } else if (key == "budget_range") {
-                std::tie(currentProduct.budgetMin, currentProduct.budgetMax) = parseRange(value);
-            } else if (key == "man_hour_per_unit") {
-                std::tie(currentProduct.manHourPerUnitMin, currentProduct.manHourPerUnitMax) = parseRange(value);
-            } else if (key == "total_man_hours") {
-                std::tie(currentProduct.totalManHoursMin, currentProduct.totalManHoursMax) = parseRange(value);
+            } else if (key == "inventory_range") {
+                std::tie(currentStock[0], currentStock[1]) = parseRange(value);
+                stockSeen = true;
+            } else if (key == "holding_cost") {
+                currentStock[2] = parseDouble(value);
+                stockSeen = true;
+            } else if (key == "initial_inventory") {
+                currentStock[3] = parseDouble(value);
+                stockSeen = true;
+            } else if (key == "profit_deltas") {
+                currentProfitDeltas = parseList(value);
+            } else if (key == "site") {
+                currentSite = siteIndex(value);
             }
         }
     }
 
-    if (!currentSection.empty() && currentSection != "Global" && currentSection != "Objectives") {
-        products[currentProduct.name] = currentProduct;
+    if (section == Section::Product) {
+        finishProduct();
+    }
+
+    // Every product of a multi-site config belongs to a site and every site has products
+    if (!sites.empty()) {
+        std::vector<bool> used(sites.sites.size(), false);
+        for (size_t i = 0; i < products.size(); ++i) {
+            if (sites.productSite[i] == noSite) {
+                throw std::invalid_argument("Product " + products.name(i) + " has no site");
+            }
+            used[sites.productSite[i]] = true;
+        }
+        for (size_t i = 0; i < used.size(); ++i) {
+            if (!used[i]) {
+                throw std::invalid_argument("Site " + sites.sites[i].name + " has no products");
+            }
+        }
+    }
+
+    // Time-indexed ranges only make sense within the periods of a [Horizon]
+    if (horizon.empty()) {
+        if (!horizon.productChanges.empty() || !horizon.globalChanges.empty()) {
+            throw std::invalid_argument("Time-indexed ranges need a [Horizon] section");
+        }
+    } else {
+        if (!sites.empty()) {
+            throw std::invalid_argument("Multi-site configs cannot have a [Horizon] section");
+        }
+        if (horizon.step > horizon.window) {
+            throw std::invalid_argument("[Horizon] step must not exceed the window");
+        }
+        auto byPeriod = [](const auto& a, const auto& b) { return a.period < b.period; };
+        std::stable_sort(horizon.productChanges.begin(), horizon.productChanges.end(), byPeriod);
+        std::stable_sort(horizon.globalChanges.begin(), horizon.globalChanges.end(), byPeriod);
+        if ((!horizon.productChanges.empty() && horizon.productChanges.back().period > horizon.periods) ||
+            (!horizon.globalChanges.empty() && horizon.globalChanges.back().period > horizon.periods)) {
+            throw std::invalid_argument("Time-indexed range after the last [Horizon] period");
+        }
+        for (std::vector<double>* column : stockColumns) {
+            column->resize(products.size(), 0.0);
+        }
     }
 
     return products;
 }
 
-bool validateInput(const std::unordered_map<std::string, Product>& products,
-                   const GlobalConstraints& globalConstraints,
-                   const std::vector<Objective>& objectives) {
-    std::vector<std::string> criticalErrors;
-    std::vector<std::string> warnings;
-
-    for (const auto& [name, product] : products) {
-        // Derive budget range
-        double minBudget = product.costMin * product.demandMin;
-        double maxBudget = product.costMax * product.demandMax;
-
-        // Validate input budget range
-        if (product.budgetMin < minBudget || product.budgetMax > maxBudget) {
-            criticalErrors.emplace_back(
-                "Product: " + name + " - Budget range [" +
-                std::to_string(product.budgetMin) + ", " +
-                std::to_string(product.budgetMax) +
-                "] is outside the realistic range [" +
-                std::to_string(minBudget) + ", " +
-                std::to_string(maxBudget) + "].");
-        } else if (product.budgetMin > minBudget || product.budgetMax < maxBudget) {
-            warnings.emplace_back(
-                "Product: " + name + " - Budget range [" +
-                std::to_string(product.budgetMin) + ", " +
-                std::to_string(product.budgetMax) +
-                "] is narrower than the realistic range [" +
-                std::to_string(minBudget) + ", " +
-                std::to_string(maxBudget) + "].");
-        }
-
-        // Derive man-hour range
-        double minManHours = product.manHourPerUnitMin * product.demandMin;
-        double maxManHours = product.manHourPerUnitMax * product.demandMax;
-
-        if (product.totalManHoursMax > 0 && product.totalManHoursMax < minManHours) {
-            criticalErrors.emplace_back(
-                "Product: " + name + " - Total man-hours range is below the realistic minimum. Suggested max: " +
-                std::to_string(maxManHours) + ".");
-        } else if (product.totalManHoursMax > maxManHours) {
-            warnings.emplace_back(
-                "Product: " + name + " - Total man-hours range exceeds the realistic maximum. Suggested max: " +
-                std::to_string(maxManHours) + ".");
-        }
-    }
-
-    // Global constraint validation
-    double totalMinBudget = 0.0, totalMaxBudget = 0.0;
-
-    for (const auto& [name, product] : products) {
-        totalMinBudget += product.costMin * product.demandMin;
-        totalMaxBudget += product.costMax * product.demandMax;
-    }
-
-    if (globalConstraints.budgetMin < totalMinBudget || globalConstraints.budgetMax > totalMaxBudget) {
+// Walk two ascending index lists in product order, the budget message of a
+// product before its man-hours message, formatting up to limit messages
+template <typename BudgetMessage, typename ManHoursMessage>
+static void formatInProductOrder(const std::vector<uint32_t>& budget, const std::vector<uint32_t>& manHours,
+                                 size_t limit, std::vector<std::string>& messages,
+                                 BudgetMessage budgetMessage, ManHoursMessage manHoursMessage) {
+    size_t b = 0, m = 0;
+    while (messages.size() < limit && (b < budget.size() || m < manHours.size())) {
+        if (m == manHours.size() || (b < budget.size() && budget[b] <= manHours[m])) {
+            messages.push_back(budgetMessage(budget[b++]));
+        } else {
+            messages.push_back(manHoursMessage(manHours[m++]));
+        }
+    }
+}
+
+ValidationReport collectValidationIssues(const ProductTable& products,
+                                         const GlobalConstraints& globalConstraints,
+                                         size_t messageLimit) {
+    PhaseTimer timer(MetricsPhase::Validate);
+    ValidationReport report;
+    std::vector<std::string>& criticalErrors = report.criticalErrors;
+    std::vector<std::string>& warnings = report.warnings;
+
+    const auto& costMin = products.column(&Product::costMin);
+    const auto& costMax = products.column(&Product::costMax);
+    const auto& demandMin = products.column(&Product::demandMin);
+    const auto& demandMax = products.column(&Product::demandMax);
+    const auto& budgetMin = products.column(&Product::budgetMin);
+    const auto& budgetMax = products.column(&Product::budgetMax);
+    const auto& manHourPerUnitMax = products.column(&Product::manHourPerUnitMax);
+
+    // Vectorized pass over every product, messages only for flagged ones
+    RangeViolations violations = checkProductRanges(products);
+    report.criticalCount = violations.budgetOutside.size() + violations.manHoursBelow.size();
+    report.warningCount = violations.budgetNarrower.size() + violations.manHoursAbove.size();
+
+    auto budgetMessage = [&](size_t i, const char* verdict) {
+        return "Product: " + products.name(i) + " - Budget range [" +
+               std::to_string(budgetMin[i]) + ", " +
+               std::to_string(budgetMax[i]) + "] is " + verdict + " the realistic range [" +
+               std::to_string(costMin[i] * demandMin[i]) + ", " +
+               std::to_string(costMax[i] * demandMax[i]) + "].";
+    };
+    auto manHoursMessage = [&](size_t i, const char* verdict) {
+        return "Product: " + products.name(i) + " - Total man-hours range " + verdict + ". Suggested max: " +
+               std::to_string(manHourPerUnitMax[i] * demandMax[i]) + ".";
+    };
+
+    formatInProductOrder(violations.budgetOutside, violations.manHoursBelow, messageLimit, criticalErrors,
+                         [&](size_t i) { return budgetMessage(i, "outside"); },
+                         [&](size_t i) { return manHoursMessage(i, "is below the realistic minimum"); });
+    formatInProductOrder(violations.budgetNarrower, violations.manHoursAbove, messageLimit, warnings,
+                         [&](size_t i) { return budgetMessage(i, "narrower than"); },
+                         [&](size_t i) { return manHoursMessage(i, "exceeds the realistic maximum"); });
+
+    // Global constraint validation, always reported. The kernel sums the
+    // totals in lanes, so a bound on the realistic range may differ from
+    // them by rounding; within the tolerance it counts as equal.
+    double totalMinBudget = violations.totalMinBudget;
+    double totalMaxBudget = violations.totalMaxBudget;
+    double minSlack = kGlobalBudgetTolerance * std::max(1.0, std::abs(totalMinBudget));
+    double maxSlack = kGlobalBudgetTolerance * std::max(1.0, std::abs(totalMaxBudget));
+
+    if (globalConstraints.budgetMin < totalMinBudget - minSlack || globalConstraints.budgetMax > totalMaxBudget + maxSlack) {
         criticalErrors.emplace_back(
             "Global budget range [" + std::to_string(globalConstraints.budgetMin) + ", " +
             std::to_string(globalConstraints.budgetMax) +
             "] is outside the realistic range [" + std::to_string(totalMinBudget) + ", " +
             std::to_string(totalMaxBudget) + "].");
-    } else if (globalConstraints.budgetMin > totalMinBudget || globalConstraints.budgetMax < totalMaxBudget) {
+        ++report.criticalCount;
+    } else if (globalConstraints.budgetMin > totalMinBudget + minSlack || globalConstraints.budgetMax < totalMaxBudget - maxSlack) {
         warnings.emplace_back(
             "Global budget range [" + std::to_string(globalConstraints.budgetMin) + ", " +
             std::to_string(globalConstraints.budgetMax) +
             "] is narrower than the realistic range [" + std::to_string(totalMinBudget) + ", " +
             std::to_string(totalMaxBudget) + "].");
+        ++report.warningCount;
     }
 
+    return report;
+}
+
+bool validateInput(const ProductTable& products,
+                   const GlobalConstraints& globalConstraints) {
+    ValidationReport report = collectValidationIssues(products, globalConstraints);
+    const std::vector<std::string>& criticalErrors = report.criticalErrors;
+    const std::vector<std::string>& warnings = report.warnings;
+
     // Print all critical errors and warnings
     if (!criticalErrors.empty()) {
         std::cerr << "\nCritical Errors:\n";
         for (const auto& error : criticalErrors) {
             std::cerr << "  - " << error << "\n";
         }
+        if (report.criticalCount > criticalErrors.size()) {
+            std::cerr << "  ... and " << report.criticalCount - criticalErrors.size() << " more\n";
+        }
         std::cerr << "Program terminated due to critical errors.\n";
         return false;
     }
@@ -191,6 +484,9 @@ bool validateInput(const std::unordered_map<std::string, Product>& products,
         for (const auto& warning : warnings) {
             std::cout << "  - " << warning << "\n";
         }
+        if (report.warningCount > warnings.size()) {
+            std::cout << "  ... and " << report.warningCount - warnings.size() << " more\n";
+        }
         std::cout << "I may still find an optimal solutions with these warnings.\n" 
                   << "Do you want to proceed? (y/n): ";
         char choice;
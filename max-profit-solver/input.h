@@ -1,21 +1,13 @@
 #ifndef INPUT_H
 #define INPUT_H
 
+#include "product_table.h"
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
-// Product-specific constraints
-struct Product {
-    std::string name;
-    double costMin, costMax;
-    double profitMin, profitMax;
-    double demandMin, demandMax;
-    double budgetMin, budgetMax;
-    double manHourPerUnitMin, manHourPerUnitMax;
-    double totalManHoursMin, totalManHoursMax;
-};
-
 // Global constraints
 struct GlobalConstraints {
     double budgetMin, budgetMax;
@@ -30,16 +22,106 @@ struct Objective {
     int rank;         // Ranking priority
 };
 
+// Perturbation grids for sensitivity analysis, values are percentages
+struct SensitivityConfig {
+    std::vector<double> profitDeltas;    // Each product's profit %, one product at a time
+    std::unordered_map<std::string, std::vector<double>> productProfitDeltas;  // Per-product overrides
+    std::vector<double> budgetDeltas;    // Global budget bounds
+    std::vector<double> manHoursDeltas;  // Global man-hours limit
+};
+
+// A plant with its own products that shares the [Global] budget and
+// man-hours with the other plants. Products name their plant with
+// "site = NAME", an optional [Site:NAME] section adds plant-level limits.
+struct SiteLimits {
+    std::string name;
+    double budgetMin = 0.0;
+    double budgetMax = std::numeric_limits<double>::max();
+    double manHoursMax = std::numeric_limits<double>::max();
+};
+
+// Plants of a multi-site config, empty for a single plant
+struct SiteConfig {
+    std::vector<SiteLimits> sites;      // In order of first mention
+    std::vector<uint32_t> productSite;  // Site of every product, product table order
+    bool empty() const { return sites.empty(); }
+};
+
+// A product range that takes a new value from a period on, written as
+// "demand_range@12 = min, max" in the product's section
+struct ProductChange {
+    uint32_t period;   // First period with the new range, counted from 1
+    uint32_t product;  // Product table index
+    uint32_t field;    // Index of the range minimum in kProductFields
+    double min, max;
+};
+
+// Same for "global_budget@12" and "global_man_hours@12" in [Global]
+struct GlobalChange {
+    uint32_t period;
+    double GlobalConstraints::* minField;
+    double GlobalConstraints::* maxField;
+    double min, max;
+};
+
+// Multi-period plan of a config with a [Horizon] section. The product and
+// global ranges of the config hold from period 1 until a change replaces
+// them. Inventory left at the end of a period is available to the next one.
+struct HorizonConfig {
+    size_t periods = 0;  // 0 without a [Horizon] section
+    size_t window = 4;   // Periods optimized together
+    size_t step = 1;     // Periods fixed before the window moves on
+    std::vector<ProductChange> productChanges;  // In period order
+    std::vector<GlobalChange> globalChanges;
+    // Per product, product table order
+    std::vector<double> inventoryMin;      // inventory_range, end-of-period stock
+    std::vector<double> inventoryMax;
+    std::vector<double> holdingCost;       // holding_cost, per unit and period
+    std::vector<double> initialInventory;  // initial_inventory
+    bool empty() const { return periods == 0; }
+};
+
+// Outcome of the input checks, messages in product order. Only the first
+// messageLimit product messages of each kind are formatted, the counts
+// cover every issue found.
+struct ValidationReport {
+    std::vector<std::string> criticalErrors;
+    std::vector<std::string> warnings;
+    size_t criticalCount = 0;
+    size_t warningCount = 0;
+};
+
 // Function declarations
-std::unordered_map<std::string, Product> parseInputConfig
+ProductTable parseInputConfig
     (const std::string& filename, 
     GlobalConstraints& globalConstraints, 
     std::vector<Objective>& objectives);
 
-bool validateInput(const std::unordered_map<std::string, 
-    Product>& products, 
-    const GlobalConstraints& globalConstraints, 
-    const std::vector<Objective>& objectives);
+// Same as above, also reading the [Sensitivity] section and per-product grids
+ProductTable parseInputConfig
+    (const std::string& filename,
+    GlobalConstraints& globalConstraints,
+    std::vector<Objective>& objectives,
+    SensitivityConfig& sensitivity);
+
+// Same as above, also reading product sites and [Site:NAME] sections, the
+// [Horizon] section and time-indexed ranges. The overloads without them
+// reject multi-site and multi-period configs.
+ProductTable parseInputConfig
+    (const std::string& filename,
+    GlobalConstraints& globalConstraints,
+    std::vector<Objective>& objectives,
+    SensitivityConfig& sensitivity,
+    SiteConfig& sites,
+    HorizonConfig& horizon);
+
+// Run the input checks without printing or prompting
+ValidationReport collectValidationIssues(const ProductTable& products,
+    const GlobalConstraints& globalConstraints,
+    size_t messageLimit = 50);
+
+bool validateInput(const ProductTable& products,
+    const GlobalConstraints& globalConstraints);
 
 #endif // INPUT_H
 
@@ -0,0 +1,218 @@
+#include "input.h"
+#include "test_util.h"
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+void writeFile(const std::string& filename, const std::string& text) {
+    std::ofstream out(filename, std::ios::binary);
+    out << text;
+}
+
+// Shortest form that reads back to the same double
+std::string exact(double value) {
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    (void)ec;
+    return std::string(buffer, end);
+}
+
+// Values with long binary expansions, so a lossy parser shows up
+Product sampleProduct(size_t index) {
+    double x = static_cast<double>(index);
+    Product product;
+    product.name = "Product_" + std::to_string(index);
+    product.costMin = 1.0 + x / 7.0;
+    product.costMax = product.costMin * 1.1;
+    product.profitMin = 2.0 + x / 3.0;
+    product.profitMax = product.profitMin + 0.1;
+    product.demandMin = 10.0 + x;
+    product.demandMax = 1e3 / 3.0 + x;
+    product.budgetMin = 0.0;
+    product.budgetMax = 1e5 / 7.0 + x;
+    product.manHourPerUnitMin = 0.5 + x / 11.0;
+    product.manHourPerUnitMax = product.manHourPerUnitMin * 1.3;
+    product.totalManHoursMin = 0.0;
+    product.totalManHoursMax = 1e4 / 9.0 + x;
+    return product;
+}
+
+std::string productSection(const Product& product) {
+    std::ostringstream out;
+    out << "[" << product.name << "]\n"
+        << "product_name = " << product.name << "\n"
+        << "cost_range = " << exact(product.costMin) << ", " << exact(product.costMax) << "\n"
+        << "profit_range = " << exact(product.profitMin) << ", " << exact(product.profitMax) << "\n"
+        << "demand_range = " << exact(product.demandMin) << ", " << exact(product.demandMax) << "\n"
+        << "budget_range = " << exact(product.budgetMin) << ", " << exact(product.budgetMax) << "\n"
+        << "man_hour_per_unit = " << exact(product.manHourPerUnitMin) << ", "
+        << exact(product.manHourPerUnitMax) << "\n"
+        << "total_man_hours = " << exact(product.totalManHoursMin) << ", "
+        << exact(product.totalManHoursMax) << "\n\n";
+    return out.str();
+}
+
+} // namespace
+
+TEST_CASE(parserRoundTripsCatalog) {
+    const size_t count = 500;
+    std::string text;
+    for (size_t i = 0; i < count; ++i) text += productSection(sampleProduct(i));
+    text += "[Global]\nglobal_budget = 0, " + exact(1e7 / 3.0) + "\nglobal_profit = 0, 1e6\n"
+            "global_man_hours = 0, " + exact(1e5 / 7.0) + "\n\n"
+            "[Objectives]\nmaximize_profit = 1\nminimize_resource_usage = 2\nminimize_budget = 3\n";
+    const std::string filename = scratchPath("catalog.config");
+    writeFile(filename, text);
+
+    GlobalConstraints globals{};
+    std::vector<Objective> objectives;
+    ProductTable products = parseInputConfig(filename, globals, objectives);
+
+    // File order is kept and every double comes back bit for bit
+    CHECK(products.size() == count);
+    for (size_t i = 0; i < count; ++i) {
+        Product expected = sampleProduct(i);
+        CHECK(products.name(i) == expected.name);
+        Product actual = products.get(i);
+        CHECK(actual.costMin == expected.costMin && actual.costMax == expected.costMax);
+        CHECK(actual.profitMin == expected.profitMin && actual.profitMax == expected.profitMax);
+        CHECK(actual.demandMin == expected.demandMin && actual.demandMax == expected.demandMax);
+        CHECK(actual.budgetMin == expected.budgetMin && actual.budgetMax == expected.budgetMax);
+        CHECK(actual.manHourPerUnitMin == expected.manHourPerUnitMin);
+        CHECK(actual.manHourPerUnitMax == expected.manHourPerUnitMax);
+        CHECK(actual.totalManHoursMin == expected.totalManHoursMin);
+        CHECK(actual.totalManHoursMax == expected.totalManHoursMax);
+    }
+    CHECK(globals.budgetMax == 1e7 / 3.0);
+    CHECK(globals.profitMax == 1e6);
+    CHECK(globals.manHoursMax == 1e5 / 7.0);
+    CHECK(objectives.size() == 3);
+    CHECK(objectives[2].name == "budget" && objectives[2].type == "minimize" && objectives[2].rank == 3);
+}
+
+TEST_CASE(parserReadsHandWrittenConfig) {
+    // Comments, tabs, a repeated product and no newline at the end of the mapping
+    const std::string filename = scratchPath("hand.config");
+    writeFile(filename,
+              "# catalog\n"
+              "[Steel]\n"
+              "product_name = Steel\n"
+              "cost_range = 10, 12\n"
+              "profit_range =\t20, 30\n"
+              "demand_range = 100, 150\n"
+              "\n"
+              "[Brass]\n"
+              "product_name = Brass\n"
+              "cost_range = 5, 6\n"
+              "\n"
+              "[Steel]\n"
+              "product_name = Steel\n"
+              "cost_range = 11, 13\n"
+              "\n"
+              "[Global]\n"
+              "global_budget = 0, 5000\n"
+              "global_profit = 0, 100\n"
+              "global_man_hours = 0, 900\n"
+              "\n"
+              "[Objectives]\n"
+              "maximize_profit = 1\n"
+              "minimize_resource_usage = 12");
+
+    GlobalConstraints globals{};
+    std::vector<Objective> objectives;
+    ProductTable products = parseInputConfig(filename, globals, objectives);
+
+    // The second [Steel] replaces the first in place, ranges it leaves out are zero
+    CHECK(products.size() == 2);
+    CHECK(products.name(0) == "Steel");
+    CHECK(products.name(1) == "Brass");
+    Product steel = products.get(0);
+    CHECK(steel.costMin == 11.0 && steel.costMax == 13.0);
+    CHECK(steel.profitMin == 0.0 && steel.demandMax == 0.0);
+    CHECK(products.get(1).costMax == 6.0);
+    CHECK(globals.budgetMax == 5000.0);
+    CHECK(globals.manHoursMax == 900.0);
+    CHECK(objectives.size() == 2);
+    CHECK(objectives[1].name == "resource_usage" && objectives[1].rank == 10);  // Ranks are capped at 10
+}
+
+TEST_CASE(parserReadsPeriodSuffixes) {
+    const std::string base =
+        "[Steel]\n"
+        "product_name = Steel\n"
+        "demand_range = 100, 150\n"
+        "demand_range@3 = 120, 160\n"
+        "demand_range@x = 1, 2\n"
+        "[Global]\n"
+        "global_budget = 0, 5000\n"
+        "global_budget@2 = 0, 4000\n"
+        "[Horizon]\n"
+        "periods = 4\n"
+        "window = 2\n";
+    const std::string filename = scratchPath("horizon.config");
+    writeFile(filename, base);
+
+    GlobalConstraints globals{};
+    std::vector<Objective> objectives;
+    SensitivityConfig sensitivity;
+    SiteConfig sites;
+    HorizonConfig horizon;
+    ProductTable products = parseInputConfig(filename, globals, objectives, sensitivity, sites, horizon);
+    CHECK(horizon.periods == 4 && horizon.window == 2 && horizon.step == 1);
+    // '@x' is no period, the key is unknown and ignored
+    CHECK(horizon.productChanges.size() == 1);
+    CHECK(horizon.productChanges[0].period == 3);
+    CHECK(horizon.productChanges[0].min == 120.0 && horizon.productChanges[0].max == 160.0);
+    CHECK(products.get(0).demandMin == 100.0);
+    CHECK(horizon.globalChanges.size() == 1 && horizon.globalChanges[0].max == 4000.0);
+
+    // Period 0, a period beyond the horizon, and time-indexed ranges without one
+    for (const std::string& text : {base + "[Steel]\nproduct_name = Steel\ndemand_range@0 = 1, 2\n",
+                                     base + "[Steel]\nproduct_name = Steel\ndemand_range@5 = 1, 2\n",
+                                     std::string("[Steel]\nproduct_name = Steel\ndemand_range@2 = 1, 2\n")}) {
+        writeFile(filename, text);
+        GlobalConstraints ignoredGlobals{};
+        std::vector<Objective> ignoredObjectives;
+        HorizonConfig ignoredHorizon;
+        CHECK_THROWS(parseInputConfig(filename, ignoredGlobals, ignoredObjectives, sensitivity, sites, ignoredHorizon));
+    }
+
+    // The overloads without a HorizonConfig reject multi-period configs
+    writeFile(filename, base);
+    CHECK_THROWS(parseInputConfig(filename, globals, objectives));
+}
+
+TEST_CASE(parserReadsEmptyFile) {
+    const std::string filename = scratchPath("empty.config");
+    writeFile(filename, "");
+    GlobalConstraints globals{};
+    std::vector<Objective> objectives;
+    CHECK(parseInputConfig(filename, globals, objectives).empty());
+    CHECK_THROWS(parseInputConfig(scratchPath("missing.config"), globals, objectives));
+}
+
+TEST_CASE(parserReadsSensitivitySection) {
+    const std::string filename = scratchPath("sensitivity.config");
+    writeFile(filename,
+              "[Steel]\n"
+              "product_name = Steel\n"
+              "profit_range = 20, 30\n"
+              "profit_deltas = -5, 5\n"
+              "\n"
+              "[Sensitivity]\n"
+              "profit_deltas = -1, 1, 2\n"
+              "global_budget_deltas = -10, 10\n");
+
+    GlobalConstraints globals{};
+    std::vector<Objective> objectives;
+    SensitivityConfig sensitivity;
+    ProductTable products = parseInputConfig(filename, globals, objectives, sensitivity);
+    CHECK(products.size() == 1);
+    CHECK(sensitivity.profitDeltas.size() == 3 && sensitivity.profitDeltas[2] == 2.0);
+    CHECK(sensitivity.productProfitDeltas.count("Steel") == 1);
+    CHECK(sensitivity.productProfitDeltas.at("Steel").size() == 2);
+    CHECK(sensitivity.budgetDeltas.size() == 2 && sensitivity.budgetDeltas[1] == 10.0);
+    CHECK(sensitivity.manHoursDeltas.empty());
+}
@@ -0,0 +1,14 @@
+// json_util.h
+#ifndef JSON_UTIL_H
+#define JSON_UTIL_H
+
+#include <string>
+#include <string_view>
+
+// Quote and escape a string for use as a JSON value
+std::string jsonString(std::string_view value);
+
+// Format a number for JSON; non-finite values become null
+std::string jsonNumber(double value);
+
+#endif // JSON_UTIL_H
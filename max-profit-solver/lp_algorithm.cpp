@@ -0,0 +1,86 @@
+#include "lp_algorithm.h"
+#include <ClpSolve.hpp>
+
+namespace {
+
+// Below this many rows plus columns simplex finishes before barrier has
+// factorized; above it barrier's iteration count stays nearly flat
+const int kBarrierMinDimension = 200000;
+
+// Dense columns fill in the normal equations A D A^T that barrier factorizes
+const double kBarrierMaxColumnElements = 16.0;
+
+} // namespace
+
+bool parseLpAlgorithm(const std::string& name, LpAlgorithm& algorithm) {
+    if (name == "auto") {
+        algorithm = LpAlgorithm::Auto;
+    } else if (name == "primal") {
+        algorithm = LpAlgorithm::Primal;
+    } else if (name == "dual") {
+        algorithm = LpAlgorithm::Dual;
+    } else if (name == "barrier") {
+        algorithm = LpAlgorithm::Barrier;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* lpAlgorithmName(LpAlgorithm algorithm) {
+    switch (algorithm) {
+        case LpAlgorithm::Primal: return "primal";
+        case LpAlgorithm::Dual: return "dual";
+        case LpAlgorithm::Barrier: return "barrier";
+        default: return "auto";
+    }
+}
+
+LpAlgorithm chooseLpAlgorithm(int rows, int columns, CoinBigIndex elements, WarmStart warmStart) {
+    switch (warmStart) {
+        case WarmStart::Optimal:
+        case WarmStart::Other:
+            return LpAlgorithm::Primal;
+        case WarmStart::Bounds:
+            return LpAlgorithm::Dual;
+        case WarmStart::None:
+            break;
+    }
+    double columnElements = columns > 0 ? static_cast<double>(elements) / columns : 0.0;
+    if (static_cast<long long>(rows) + columns >= kBarrierMinDimension && columnElements <= kBarrierMaxColumnElements) {
+        return LpAlgorithm::Barrier;
+    }
+    return LpAlgorithm::Dual;
+}
+
+LpAlgorithm runLpAlgorithm(ClpSimplex& model, LpAlgorithm algorithm, WarmStart warmStart, bool presolve) {
+    if (warmStart == WarmStart::Optimal) {
+        algorithm = LpAlgorithm::Primal;
+    } else if (algorithm == LpAlgorithm::Auto) {
+        algorithm = chooseLpAlgorithm(model.numberRows(), model.numberColumns(), model.getNumElements(), warmStart);
+    }
+
+    // Simplex continues from the basis in place, barrier starts over anyway
+    if (warmStart != WarmStart::None && algorithm != LpAlgorithm::Barrier) {
+        if (algorithm == LpAlgorithm::Dual) {
+            model.dual();
+            // A basis that is not dual feasible either can stall dual, primal finishes it
+            if (model.status() != 0 && model.status() != 1) {
+                model.primal();
+            }
+        } else {
+            model.primal();
+        }
+        return algorithm;
+    }
+
+    ClpSolve solveOptions;
+    switch (algorithm) {
+        case LpAlgorithm::Primal: solveOptions.setSolveType(ClpSolve::usePrimal); break;
+        case LpAlgorithm::Dual: solveOptions.setSolveType(ClpSolve::useDual); break;
+        default: solveOptions.setSolveType(ClpSolve::useBarrier); break;
+    }
+    solveOptions.setPresolveType(presolve ? ClpSolve::presolveOn : ClpSolve::presolveOff);
+    model.initialSolve(solveOptions);
+    return algorithm;
+}
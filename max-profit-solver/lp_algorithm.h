@@ -0,0 +1,38 @@
+// lp_algorithm.h
+#ifndef LP_ALGORITHM_H
+#define LP_ALGORITHM_H
+
+#include <string>
+#include <ClpSimplex.hpp>
+
+// Clp algorithm for a solve
+enum class LpAlgorithm {
+    Auto,     // Picked per solve by chooseLpAlgorithm
+    Primal,
+    Dual,
+    Barrier   // Interior point followed by crossover to an optimal basis
+};
+
+// Basis the model holds when a solve starts
+enum class WarmStart {
+    None,     // Slack basis
+    Optimal,  // Already optimal for this model (fast path or cached solution)
+    Bounds,   // Optimal before bound edits only, so still dual feasible
+    Other     // Optimal for a nearby model with other costs, coefficients or bounds
+};
+
+// "auto", "primal", "dual" or "barrier"; false for anything else
+bool parseLpAlgorithm(const std::string& name, LpAlgorithm& algorithm);
+const char* lpAlgorithmName(LpAlgorithm algorithm);
+
+// Warm bases keep simplex: primal when the basis stays primal feasible, dual
+// after bound edits. Cold solves use barrier on large sparse models, where
+// simplex iterations grow with the row count, and dual simplex otherwise.
+LpAlgorithm chooseLpAlgorithm(int rows, int columns, CoinBigIndex elements, WarmStart warmStart);
+
+// Solve the loaded model and return the algorithm that ran. Presolve only
+// applies to cold solves since it discards the basis, and an optimal basis
+// is always confirmed with primal whatever the requested algorithm.
+LpAlgorithm runLpAlgorithm(ClpSimplex& model, LpAlgorithm algorithm, WarmStart warmStart, bool presolve);
+
+#endif // LP_ALGORITHM_H
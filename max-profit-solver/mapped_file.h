@@ -0,0 +1,33 @@
+// mapped_file.h
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map the file, returns false if it cannot be opened or mapped
+    bool open(const std::string& filename);
+    void close();
+
+    const char* data() const { return static_cast<const char*>(address); }
+    size_t size() const { return length; }
+    std::string_view view() const { return {data(), length}; }
+
+private:
+    void* address = nullptr;
+    size_t length = 0;
+};
+
+#endif // MAPPED_FILE_H
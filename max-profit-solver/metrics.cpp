@@ -0,0 +1,218 @@
+#include "metrics.h"
+#include "json_util.h"
+#include "solution_cache.h"
+#include "solver.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <sys/resource.h>
+
+std::atomic<bool> metricsOn{false};
+
+namespace {
+
+const char* const kPhaseNames[] = {
+    "parse", "validate", "setup_model", "apply_constraints", "define_objective", "solve", "report",
+};
+static_assert(sizeof(kPhaseNames) / sizeof(kPhaseNames[0]) == static_cast<size_t>(MetricsPhase::Count),
+              "every phase needs a name");
+
+struct PhaseTotals {
+    uint64_t count = 0;
+    double wallSeconds = 0.0;
+    double cpuSeconds = 0.0;
+};
+
+struct MetricsState {
+    std::mutex mutex;
+    PhaseTotals phases[static_cast<size_t>(MetricsPhase::Count)];
+    std::map<int, uint64_t> solvesByStatus;
+    uint64_t iterations = 0;
+    int lastStatus = -1;
+    int rows = 0;
+    int columns = 0;
+};
+
+MetricsState& state() {
+    static MetricsState metrics;
+    return metrics;
+}
+
+double secondsBetween(const timespec& start, const timespec& end) {
+    return static_cast<double>(end.tv_sec - start.tv_sec) + static_cast<double>(end.tv_nsec - start.tv_nsec) * 1e-9;
+}
+
+double toSeconds(const timeval& time) {
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_usec) * 1e-6;
+}
+
+// ru_maxrss is kilobytes on Linux and bytes on macOS
+uint64_t peakRssBytes(const rusage& usage) {
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+std::string formatJson(const MetricsState& metrics, const rusage& usage) {
+    std::ostringstream out;
+    uint64_t solves = 0;
+    for (const auto& [status, count] : metrics.solvesByStatus) solves += count;
+
+    out << "{\"peak_rss_bytes\":" << peakRssBytes(usage)
+        << ",\"process_cpu_seconds\":" << jsonNumber(toSeconds(usage.ru_utime) + toSeconds(usage.ru_stime))
+        << ",\"solves\":" << solves
+        << ",\"simplex_iterations\":" << metrics.iterations
+        << ",\"last_status\":" << jsonString(solveStatusName(metrics.lastStatus))
+        << ",\"rows\":" << metrics.rows
+        << ",\"columns\":" << metrics.columns;
+    CacheStats cache = solutionCacheStats();
+    out << ",\"cache\":{\"exact_hits\":" << cache.exactHits << ",\"near_hits\":" << cache.nearHits
+        << ",\"misses\":" << cache.misses << ",\"stores\":" << cache.stores
+        << ",\"evictions\":" << cache.evictions << "}"
+        << ",\"solves_by_status\":{";
+    bool first = true;
+    for (const auto& [status, count] : metrics.solvesByStatus) {
+        out << (first ? "" : ",") << jsonString(solveStatusName(status)) << ":" << count;
+        first = false;
+    }
+    out << "},\"phases\":{";
+    for (size_t i = 0; i < static_cast<size_t>(MetricsPhase::Count); ++i) {
+        const PhaseTotals& phase = metrics.phases[i];
+        out << (i ? "," : "") << jsonString(kPhaseNames[i]) << ":{\"count\":" << phase.count
+            << ",\"wall_seconds\":" << jsonNumber(phase.wallSeconds)
+            << ",\"cpu_seconds\":" << jsonNumber(phase.cpuSeconds) << "}";
+    }
+    out << "}}\n";
+    return out.str();
+}
+
+std::string formatPrometheus(const MetricsState& metrics, const rusage& usage) {
+    std::ostringstream out;
+    auto header = [&out](const char* name, const char* type, const char* help) {
+        out << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+    };
+    auto phaseSeries = [&](const char* name, const char* help, auto value) {
+        header(name, "counter", help);
+        for (size_t i = 0; i < static_cast<size_t>(MetricsPhase::Count); ++i) {
+            out << name << "{phase=\"" << kPhaseNames[i] << "\"} " << value(metrics.phases[i]) << "\n";
+        }
+    };
+
+    phaseSeries("profit_phase_runs_total", "Times each phase ran.",
+                [](const PhaseTotals& phase) { return std::to_string(phase.count); });
+    phaseSeries("profit_phase_wall_seconds_total", "Wall time spent in each phase.",
+                [](const PhaseTotals& phase) { return jsonNumber(phase.wallSeconds); });
+    phaseSeries("profit_phase_cpu_seconds_total", "CPU time of the thread running each phase.",
+                [](const PhaseTotals& phase) { return jsonNumber(phase.cpuSeconds); });
+
+    header("profit_solves_total", "counter", "Solves and re-solves by final status.");
+    for (const auto& [status, count] : metrics.solvesByStatus) {
+        out << "profit_solves_total{status=\"" << solveStatusName(status) << "\"} " << count << "\n";
+    }
+    header("profit_simplex_iterations_total", "counter", "Simplex iterations over all solves.");
+    out << "profit_simplex_iterations_total " << metrics.iterations << "\n";
+    CacheStats cache = solutionCacheStats();
+    header("profit_cache_lookups_total", "counter", "Solution cache lookups by result.");
+    out << "profit_cache_lookups_total{result=\"exact\"} " << cache.exactHits << "\n"
+        << "profit_cache_lookups_total{result=\"near\"} " << cache.nearHits << "\n"
+        << "profit_cache_lookups_total{result=\"miss\"} " << cache.misses << "\n";
+    header("profit_cache_stores_total", "counter", "Solutions written to the cache.");
+    out << "profit_cache_stores_total " << cache.stores << "\n";
+    header("profit_cache_evictions_total", "counter", "Cache entries removed to stay under the size limit.");
+    out << "profit_cache_evictions_total " << cache.evictions << "\n";
+    header("profit_model_rows", "gauge", "Rows of the most recently solved model.");
+    out << "profit_model_rows " << metrics.rows << "\n";
+    header("profit_model_columns", "gauge", "Columns of the most recently solved model.");
+    out << "profit_model_columns " << metrics.columns << "\n";
+    header("profit_peak_rss_bytes", "gauge", "Peak resident set size of the process.");
+    out << "profit_peak_rss_bytes " << peakRssBytes(usage) << "\n";
+    header("profit_process_cpu_seconds_total", "counter", "User plus system CPU time of the process.");
+    out << "profit_process_cpu_seconds_total " << jsonNumber(toSeconds(usage.ru_utime) + toSeconds(usage.ru_stime))
+        << "\n";
+    return out.str();
+}
+
+} // namespace
+
+void enableMetrics() {
+    metricsOn.store(true, std::memory_order_relaxed);
+}
+
+PhaseTimer::PhaseTimer(MetricsPhase phase, double* wallMillis)
+    : phase(phase), wallMillis(wallMillis), recording(metricsEnabled()) {
+    if (recording || wallMillis) {
+        clock_gettime(CLOCK_MONOTONIC, &wallStart);
+    }
+    if (recording) {
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuStart);
+    }
+}
+
+PhaseTimer::~PhaseTimer() {
+    if (!recording && !wallMillis) {
+        return;
+    }
+    timespec wallEnd{};
+    clock_gettime(CLOCK_MONOTONIC, &wallEnd);
+    double wallSeconds = secondsBetween(wallStart, wallEnd);
+    if (wallMillis) {
+        *wallMillis = wallSeconds * 1000.0;
+    }
+    if (recording) {
+        timespec cpuEnd{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuEnd);
+        MetricsState& metrics = state();
+        std::lock_guard<std::mutex> lock(metrics.mutex);
+        PhaseTotals& totals = metrics.phases[static_cast<size_t>(phase)];
+        ++totals.count;
+        totals.wallSeconds += wallSeconds;
+        totals.cpuSeconds += secondsBetween(cpuStart, cpuEnd);
+    }
+}
+
+void recordSolveMetrics(int status, int iterations, int rows, int columns) {
+    if (!metricsEnabled()) {
+        return;
+    }
+    MetricsState& metrics = state();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    ++metrics.solvesByStatus[status];
+    metrics.iterations += static_cast<uint64_t>(iterations);
+    metrics.lastStatus = status;
+    metrics.rows = rows;
+    metrics.columns = columns;
+}
+
+void writeMetrics(const std::string& filename, MetricsFormat format) {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::string text;
+    {
+        MetricsState& metrics = state();
+        std::lock_guard<std::mutex> lock(metrics.mutex);
+        text = format == MetricsFormat::Prometheus ? formatPrometheus(metrics, usage) : formatJson(metrics, usage);
+    }
+
+    std::string temporary = filename + ".tmp";
+    {
+        std::ofstream out(temporary);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open metrics file: " + temporary);
+        }
+        out << text;
+        if (!out.flush()) {
+            throw std::runtime_error("Failed to write metrics file: " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Failed to replace metrics file: " + filename);
+    }
+}
@@ -0,0 +1,60 @@
+// metrics.h
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <ctime>
+#include <string>
+
+// Instrumented steps, in the order they run
+enum class MetricsPhase {
+    Parse,             // parseInputConfig or a compiled model load
+    Validate,          // collectValidationIssues
+    SetupModel,
+    ApplyConstraints,
+    DefineObjective,
+    Solve,             // Structured fast path and/or Clp, warm re-solves included
+    Report,
+    Count
+};
+
+enum class MetricsFormat { Json, Prometheus };
+
+// Process-wide and off by default. While off every hook is one relaxed
+// load and a branch, so the instrumentation stays compiled in.
+extern std::atomic<bool> metricsOn;
+
+inline bool metricsEnabled() {
+    return metricsOn.load(std::memory_order_relaxed);
+}
+
+void enableMetrics();
+
+// Times one phase for the lifetime of the object. When wallMillis is given
+// the wall time is always stored there, metrics on or off; CPU time is
+// only sampled while metrics are on.
+class PhaseTimer {
+public:
+    explicit PhaseTimer(MetricsPhase phase, double* wallMillis = nullptr);
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    MetricsPhase phase;
+    double* wallMillis;
+    bool recording;
+    timespec wallStart{};
+    timespec cpuStart{};
+};
+
+// Outcome of one solve or re-solve, ignored while metrics are off
+void recordSolveMetrics(int status, int iterations, int rows, int columns);
+
+// Snapshot of everything recorded so far plus peak RSS and process CPU
+// time. The file is replaced atomically, so a Prometheus textfile
+// collector never reads half of it.
+void writeMetrics(const std::string& filename, MetricsFormat format);
+
+#endif // METRICS_H
@@ -0,0 +1,274 @@
+#include "model_file.h"
+#include "metrics.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+const char kMagic[8] = {'P', 'M', 'M', 'O', 'D', 'E', 'L', '\0'};
+const uint32_t kEndianTag = 0x01020304;
+
+// The payload stores the range fields in ProductTable column order
+const size_t kFieldCount = kProductFieldCount;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint64_t productCount;
+    uint64_t objectiveCount;
+    uint64_t namesBytes;
+    uint64_t payloadBytes;
+    uint64_t checksum;
+    uint64_t reserved;
+};
+
+struct ObjectiveRecord {
+    uint64_t nameOffset;
+    uint32_t nameLength;
+    uint32_t type;      // 0 = maximize, 1 = minimize
+    int32_t rank;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 64, "compiled model header must stay 64 bytes");
+static_assert(sizeof(ObjectiveRecord) == 24, "objective record must stay 24 bytes");
+
+size_t alignTo8(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+// Section offsets inside the payload for the given counts
+struct PayloadLayout {
+    size_t globals, columns, nameOffsets, objectives, names, total;
+
+    PayloadLayout(uint64_t productCount, uint64_t objectiveCount, uint64_t namesBytes) {
+        globals = 0;
+        columns = globals + 6 * sizeof(double);
+        nameOffsets = columns + kFieldCount * productCount * sizeof(double);
+        objectives = nameOffsets + (productCount + 1) * sizeof(uint64_t);
+        names = objectives + objectiveCount * sizeof(ObjectiveRecord);
+        total = alignTo8(names + namesBytes);
+    }
+};
+
+// Four independent multiply-xor lanes over 64-bit words, fast enough to
+// verify a million-product payload in a few milliseconds
+uint64_t checksum64(const unsigned char* data, size_t size) {
+    const uint64_t prime = 0x100000001b3ull;
+    uint64_t lanes[4] = {0xcbf29ce484222325ull, 0x84222325cbf29ce4ull, 0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full};
+
+    size_t words = size / 8;
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, data + (i + lane) * 8, 8);
+            lanes[lane] = (lanes[lane] ^ word) * prime;
+            lanes[lane] ^= lanes[lane] >> 29;
+        }
+    }
+    for (; i < words; ++i) {
+        uint64_t word;
+        std::memcpy(&word, data + i * 8, 8);
+        lanes[0] = ((lanes[0] ^ word) * prime) ^ (lanes[0] >> 29);
+    }
+    for (size_t byte = words * 8; byte < size; ++byte) {
+        lanes[1] = (lanes[1] ^ data[byte]) * prime;
+    }
+
+    uint64_t hash = size;
+    for (uint64_t lane : lanes) {
+        hash = (hash ^ lane) * prime;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+[[noreturn]] void invalidModel(const std::string& filename, const std::string& reason) {
+    throw std::runtime_error("Invalid compiled model file " + filename + ": " + reason);
+}
+
+} // namespace
+
+CompiledModel::CompiledModel(const std::string& filename) {
+    if (!file.open(filename)) {
+        throw std::runtime_error("Failed to open compiled model file: " + filename);
+    }
+
+    FileHeader header;
+    if (file.size() < sizeof(header)) {
+        invalidModel(filename, "truncated header");
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        invalidModel(filename, "bad magic");
+    }
+    if (header.endianTag != kEndianTag) {
+        invalidModel(filename, "written on a machine with a different byte order");
+    }
+    if (header.version != kCompiledModelVersion) {
+        invalidModel(filename, "unsupported version " + std::to_string(header.version) +
+                               " (expected " + std::to_string(kCompiledModelVersion) + ")");
+    }
+
+    PayloadLayout layout(header.productCount, header.objectiveCount, header.namesBytes);
+    if (header.payloadBytes != layout.total || file.size() - sizeof(header) != layout.total) {
+        invalidModel(filename, "size does not match its header");
+    }
+
+    const unsigned char* payload = reinterpret_cast<const unsigned char*>(file.data()) + sizeof(header);
+    if (checksum64(payload, layout.total) != header.checksum) {
+        invalidModel(filename, "checksum mismatch");
+    }
+
+    numProducts = header.productCount;
+    std::memcpy(&globals, payload + layout.globals, sizeof(globals));
+
+    // The mapping is page aligned and every section 8-byte aligned, so the
+    // arrays are used in place
+    columns.resize(kFieldCount);
+    for (size_t field = 0; field < kFieldCount; ++field) {
+        columns[field] = reinterpret_cast<const double*>(payload + layout.columns + field * numProducts * sizeof(double));
+    }
+    nameOffsets = reinterpret_cast<const uint64_t*>(payload + layout.nameOffsets);
+    names = reinterpret_cast<const char*>(payload + layout.names);
+
+    if (nameOffsets[numProducts] > header.namesBytes) {
+        invalidModel(filename, "name table out of range");
+    }
+    for (size_t i = 0; i < numProducts; ++i) {
+        if (nameOffsets[i] > nameOffsets[i + 1]) {
+            invalidModel(filename, "name table out of order");
+        }
+    }
+
+    objectiveList.reserve(header.objectiveCount);
+    for (size_t i = 0; i < header.objectiveCount; ++i) {
+        ObjectiveRecord record;
+        std::memcpy(&record, payload + layout.objectives + i * sizeof(record), sizeof(record));
+        if (record.nameOffset + record.nameLength > header.namesBytes) {
+            invalidModel(filename, "objective name out of range");
+        }
+        objectiveList.push_back({std::string(names + record.nameOffset, record.nameLength),
+                                 record.type == 0 ? "maximize" : "minimize", record.rank});
+    }
+}
+
+std::string_view CompiledModel::productName(size_t index) const {
+    return {names + nameOffsets[index], static_cast<size_t>(nameOffsets[index + 1] - nameOffsets[index])};
+}
+
+const double* CompiledModel::column(double Product::*field) const {
+    for (size_t i = 0; i < kFieldCount; ++i) {
+        if (kProductFields[i] == field) {
+            return columns[i];
+        }
+    }
+    throw std::invalid_argument("Unknown product field");
+}
+
+bool isCompiledModel(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+void writeCompiledModel(const std::string& filename,
+                        const ProductTable& products,
+                        const GlobalConstraints& globalConstraints,
+                        const std::vector<Objective>& objectives) {
+    // Intern every name once into a single table
+    std::string namesTable;
+    std::unordered_map<std::string, uint64_t> interned;
+    auto intern = [&](const std::string& name) {
+        auto [it, inserted] = interned.try_emplace(name, namesTable.size());
+        if (inserted) namesTable += name;
+        return it->second;
+    };
+
+    std::vector<uint64_t> nameOffsets;
+    nameOffsets.reserve(products.size() + 1);
+    for (size_t i = 0; i < products.size(); ++i) {
+        nameOffsets.push_back(intern(products.name(i)));
+    }
+    // Product names are contiguous so offset[i + 1] marks the end of name i
+    nameOffsets.push_back(namesTable.size());
+
+    std::vector<ObjectiveRecord> objectiveRecords;
+    for (const auto& objective : objectives) {
+        ObjectiveRecord record{};
+        record.nameOffset = intern(objective.name);
+        record.nameLength = static_cast<uint32_t>(objective.name.size());
+        record.type = objective.type == "maximize" ? 0 : 1;
+        record.rank = objective.rank;
+        objectiveRecords.push_back(record);
+    }
+
+    PayloadLayout layout(products.size(), objectiveRecords.size(), namesTable.size());
+    std::vector<unsigned char> payload(layout.total, 0);
+
+    std::memcpy(payload.data() + layout.globals, &globalConstraints, sizeof(globalConstraints));
+    for (size_t field = 0; field < kFieldCount; ++field) {
+        const std::vector<double>& column = products.column(kProductFields[field]);
+        if (!column.empty()) {
+            std::memcpy(payload.data() + layout.columns + field * products.size() * sizeof(double),
+                        column.data(), column.size() * sizeof(double));
+        }
+    }
+    std::memcpy(payload.data() + layout.nameOffsets, nameOffsets.data(), nameOffsets.size() * sizeof(uint64_t));
+    if (!objectiveRecords.empty()) {
+        std::memcpy(payload.data() + layout.objectives, objectiveRecords.data(), objectiveRecords.size() * sizeof(ObjectiveRecord));
+    }
+    std::memcpy(payload.data() + layout.names, namesTable.data(), namesTable.size());
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kCompiledModelVersion;
+    header.endianTag = kEndianTag;
+    header.productCount = products.size();
+    header.objectiveCount = objectiveRecords.size();
+    header.namesBytes = namesTable.size();
+    header.payloadBytes = layout.total;
+    header.checksum = checksum64(payload.data(), payload.size());
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open compiled model file for writing: " + filename);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    if (!out) {
+        throw std::runtime_error("Failed to write compiled model file: " + filename);
+    }
+}
+
+ProductTable loadCompiledModel(const std::string& filename,
+                               GlobalConstraints& globalConstraints,
+                               std::vector<Objective>& objectives) {
+    PhaseTimer timer(MetricsPhase::Parse);
+    CompiledModel model(filename);
+    globalConstraints = model.globalConstraints();
+    objectives = model.objectives();
+
+    // One bulk copy per mapped column, the name index is built in one pass
+    const double* columns[kFieldCount];
+    for (size_t field = 0; field < kFieldCount; ++field) {
+        columns[field] = model.column(kProductFields[field]);
+    }
+    std::vector<std::string> names;
+    names.reserve(model.productCount());
+    for (size_t i = 0; i < model.productCount(); ++i) {
+        names.emplace_back(model.productName(i));
+    }
+
+    ProductTable products;
+    try {
+        products.assignColumns(std::move(names), columns);
+    } catch (const std::invalid_argument& ex) {
+        invalidModel(filename, ex.what());
+    }
+    return products;
+}
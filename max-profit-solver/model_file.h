@@ -0,0 +1,62 @@
+// model_file.h
+#ifndef MODEL_FILE_H
+#define MODEL_FILE_H
+
+#include "input.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compiled model file layout (version 1, native little-endian):
+//   header      magic "PMMODEL", version, endian tag, counts, payload size, checksum
+//   payload     global constraints (6 doubles)
+//               one contiguous double array per Product range field
+//               product name offsets (productCount + 1) into the names table
+//               objective records (name offset/length, type, rank)
+//               interned names table
+// Every payload section starts on an 8-byte boundary.
+constexpr uint32_t kCompiledModelVersion = 1;
+
+// Read-only view over a memory-mapped compiled model
+class CompiledModel {
+public:
+    // Map and verify the file, throws std::runtime_error if it is not a valid model
+    explicit CompiledModel(const std::string& filename);
+
+    size_t productCount() const { return numProducts; }
+    std::string_view productName(size_t index) const;
+
+    // Contiguous values of one Product field, e.g. column(&Product::costMin)
+    const double* column(double Product::*field) const;
+
+    const GlobalConstraints& globalConstraints() const { return globals; }
+    const std::vector<Objective>& objectives() const { return objectiveList; }
+
+private:
+    MappedFile file;
+    size_t numProducts = 0;
+    GlobalConstraints globals{};
+    std::vector<Objective> objectiveList;
+    std::vector<const double*> columns;
+    const uint64_t* nameOffsets = nullptr;
+    const char* names = nullptr;
+};
+
+// True if the file starts with the compiled model magic
+bool isCompiledModel(const std::string& filename);
+
+// Serialize parsed inputs into a compiled model file
+void writeCompiledModel(const std::string& filename,
+    const ProductTable& products,
+    const GlobalConstraints& globalConstraints,
+    const std::vector<Objective>& objectives);
+
+// Load a compiled model, the compiled counterpart of parseInputConfig
+ProductTable loadCompiledModel
+    (const std::string& filename,
+    GlobalConstraints& globalConstraints,
+    std::vector<Objective>& objectives);
+
+#endif // MODEL_FILE_H
@@ -0,0 +1,111 @@
+#include "model_file.h"
+#include "test_util.h"
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+struct CompiledInputs {
+    ProductTable products;
+    GlobalConstraints globals{};
+    std::vector<Objective> objectives;
+};
+
+CompiledInputs writeModel(const std::string& filename, size_t count) {
+    CompiledInputs inputs;
+    for (size_t i = 0; i < count; ++i) {
+        double x = static_cast<double>(i);
+        Product product;
+        product.name = "Product_" + std::to_string(i);
+        product.costMin = 1.0 + x / 7.0;
+        product.costMax = product.costMin * 1.1;
+        product.profitMin = 2.0 + x / 3.0;
+        product.profitMax = product.profitMin + 0.1;
+        product.demandMin = 10.0 + x;
+        product.demandMax = 1e3 / 3.0 + x;
+        product.budgetMin = 0.0;
+        product.budgetMax = 1e5 / 7.0 + x;
+        product.manHourPerUnitMin = 0.5 + x / 11.0;
+        product.manHourPerUnitMax = product.manHourPerUnitMin * 1.3;
+        product.totalManHoursMin = 0.0;
+        product.totalManHoursMax = 1e4 / 9.0 + x;
+        inputs.products.insertOrAssign(product);
+    }
+    inputs.globals = {0.0, 1e7 / 3.0, 0.0, 1e6, 0.0, 1e5 / 7.0};
+    inputs.objectives = {{"profit", "maximize", 1}, {"resource_usage", "minimize", 2}, {"budget", "minimize", 3}};
+    writeCompiledModel(filename, inputs.products, inputs.globals, inputs.objectives);
+    return inputs;
+}
+
+} // namespace
+
+TEST_CASE(compiledModelRoundTrips) {
+    const std::string filename = scratchPath("round_trip.pmm");
+    CompiledInputs written = writeModel(filename, 300);
+    CHECK(isCompiledModel(filename));
+
+    GlobalConstraints globals{};
+    std::vector<Objective> objectives;
+    ProductTable products = loadCompiledModel(filename, globals, objectives);
+    CHECK(products.size() == written.products.size());
+    for (size_t i = 0; i < products.size(); ++i) {
+        CHECK(products.name(i) == written.products.name(i));
+        CHECK(products.find(products.name(i)) == i);
+        for (auto field : kProductFields) {
+            CHECK(products.column(field)[i] == written.products.column(field)[i]);
+        }
+    }
+    CHECK(globals.budgetMin == written.globals.budgetMin);
+    CHECK(globals.budgetMax == written.globals.budgetMax);
+    CHECK(globals.manHoursMax == written.globals.manHoursMax);
+    CHECK(objectives.size() == written.objectives.size());
+    for (size_t i = 0; i < objectives.size(); ++i) {
+        CHECK(objectives[i].name == written.objectives[i].name);
+        CHECK(objectives[i].type == written.objectives[i].type);
+        CHECK(objectives[i].rank == written.objectives[i].rank);
+    }
+
+    // The mapped view reads the same columns without copying them
+    CompiledModel compiled(filename);
+    CHECK(compiled.productCount() == written.products.size());
+    CHECK(compiled.productName(299) == written.products.name(299));
+    CHECK(compiled.column(&Product::demandMax)[42] == written.products.column(&Product::demandMax)[42]);
+}
+
+TEST_CASE(compiledModelRoundTripsEmptyCatalog) {
+    const std::string filename = scratchPath("empty.pmm");
+    writeCompiledModel(filename, ProductTable(), GlobalConstraints{}, {});
+    GlobalConstraints globals{};
+    std::vector<Objective> objectives;
+    CHECK(loadCompiledModel(filename, globals, objectives).empty());
+    CHECK(objectives.empty());
+}
+
+TEST_CASE(compiledModelRejectsDamagedFiles) {
+    const std::string filename = scratchPath("damaged.pmm");
+    writeModel(filename, 50);
+    uintmax_t size = std::filesystem::file_size(filename);
+
+    // One flipped payload byte fails the checksum
+    {
+        std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(size - 9));
+        char byte = 0;
+        file.read(&byte, 1);
+        byte = static_cast<char>(byte ^ 0x40);
+        file.seekp(static_cast<std::streamoff>(size - 9));
+        file.write(&byte, 1);
+    }
+    CHECK_THROWS(CompiledModel model(filename));
+
+    // So does a truncated file
+    writeModel(filename, 50);
+    std::filesystem::resize_file(filename, size / 2);
+    CHECK_THROWS(CompiledModel model(filename));
+
+    // A config file is not a compiled model
+    const std::string config = scratchPath("plain.config");
+    std::ofstream(config) << "[Global]\nglobal_budget = 0, 1\n";
+    CHECK(!isCompiledModel(config));
+    CHECK_THROWS(CompiledModel model(config));
+}
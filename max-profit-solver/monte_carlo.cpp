@@ -0,0 +1,426 @@
+#include "monte_carlo.h"
+#include "json_util.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// AVX-512 implies FMA, and a fused multiply-add would round differently from
+// the scalar path; keep every kernel to separate multiplies and adds
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace {
+
+const size_t kLanes = 8;              // Samples per kernel step
+const size_t kSampleBlock = 1024;     // Samples per task, a multiple of kLanes
+const uint32_t kFields = 3;           // Cost, profit %, man-hours per unit
+
+enum class Isa { Scalar, Avx2, Avx512 };
+
+Isa detectIsa() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Isa::Avx512;
+    if (__builtin_cpu_supports("avx2")) return Isa::Avx2;
+#endif
+    return Isa::Scalar;
+}
+
+const Isa kIsa = detectIsa();
+
+uint64_t splitMix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// 32-bit integer hash, cheap enough to run eight lanes wide
+inline uint32_t mix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+uint32_t sampleKey(uint64_t seed, size_t sample) {
+    return static_cast<uint32_t>(splitMix(seed ^ splitMix(sample)));
+}
+
+// Hashed before it meets the sample key, so two samples never see the same
+// draws merely shifted by a few products
+uint32_t drawKey(size_t product, uint32_t field) {
+    return mix32(static_cast<uint32_t>(product) * kFields + field + 0x7F4A7C15u);
+}
+
+// (bits + 0.5) / 2^32 is exact in double and never 0 or 1
+inline double uniform(uint32_t bits) {
+    return (static_cast<double>(bits) + 0.5) * 0x1p-32;
+}
+
+inline double draw(uint32_t key, uint32_t productKey, double low, double span) {
+    return low + uniform(mix32(key ^ productKey)) * span;
+}
+
+// Products with units in the plan, gathered once so the kernel streams
+// contiguous columns. Idle products add the same violation to every sample.
+struct ActiveColumns {
+    std::vector<uint32_t> costKey, percentKey, perUnitKey;
+    std::vector<double> units, costMin, costSpan, percentMin, percentSpan, perUnitMin, perUnitSpan;
+    std::vector<double> budgetMin, budgetMax, totalManHoursMax;
+    double idleBudgetViolation = 0.0;
+    double idleManHoursViolation = 0.0;
+};
+
+ActiveColumns gatherActive(const PlanColumns& plan) {
+    ActiveColumns c;
+    for (size_t i = 0; i < plan.count; ++i) {
+        if (plan.units[i] == 0.0) {
+            c.idleBudgetViolation += std::max(0.0, plan.budgetMin[i]) + std::max(0.0, -plan.budgetMax[i]);
+            c.idleManHoursViolation += std::max(0.0, -plan.totalManHoursMax[i]);
+            continue;
+        }
+        c.costKey.push_back(drawKey(i, 0));
+        c.percentKey.push_back(drawKey(i, 1));
+        c.perUnitKey.push_back(drawKey(i, 2));
+        c.units.push_back(plan.units[i]);
+        c.costMin.push_back(plan.costMin[i]);
+        c.costSpan.push_back(plan.costMax[i] - plan.costMin[i]);
+        c.percentMin.push_back(plan.profitMin[i]);
+        c.percentSpan.push_back(plan.profitMax[i] - plan.profitMin[i]);
+        c.perUnitMin.push_back(plan.manHourPerUnitMin[i]);
+        c.perUnitSpan.push_back(plan.manHourPerUnitMax[i] - plan.manHourPerUnitMin[i]);
+        c.budgetMin.push_back(plan.budgetMin[i]);
+        c.budgetMax.push_back(plan.budgetMax[i]);
+        c.totalManHoursMax.push_back(plan.totalManHoursMax[i]);
+    }
+    return c;
+}
+
+// One sample, the reference every vector lane matches bit for bit
+void sampleScalar(const ActiveColumns& c, uint64_t seed, size_t sample, SampleOutcomes& out) {
+    uint32_t key = sampleKey(seed, sample);
+    double profit = 0.0, budget = 0.0, manHours = 0.0, budgetViolation = 0.0, manHoursViolation = 0.0;
+    for (size_t j = 0; j < c.units.size(); ++j) {
+        double cost = draw(key, c.costKey[j], c.costMin[j], c.costSpan[j]);
+        double percent = draw(key, c.percentKey[j], c.percentMin[j], c.percentSpan[j]);
+        double perUnit = draw(key, c.perUnitKey[j], c.perUnitMin[j], c.perUnitSpan[j]);
+        double budgetUsed = c.units[j] * cost;
+        double manHoursUsed = c.units[j] * perUnit;
+        profit += budgetUsed * percent / 100.0;
+        budget += budgetUsed;
+        manHours += manHoursUsed;
+        budgetViolation += std::max(0.0, c.budgetMin[j] - budgetUsed) + std::max(0.0, budgetUsed - c.budgetMax[j]);
+        manHoursViolation += std::max(0.0, manHoursUsed - c.totalManHoursMax[j]);
+    }
+    out.profit[sample] = profit;
+    out.budget[sample] = budget;
+    out.manHours[sample] = manHours;
+    out.budgetViolation[sample] = budgetViolation;
+    out.manHoursViolation[sample] = manHoursViolation;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("avx2")))
+inline __m256i mix32x8(__m256i x) {
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(0x7FEB352D));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(0x846CA68Bu)));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    return x;
+}
+
+__attribute__((target("avx2")))
+inline __m256i laneKeys(uint64_t seed, size_t first) {
+    alignas(32) uint32_t keys[kLanes];
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        keys[lane] = sampleKey(seed, first + lane);
+    }
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(keys));
+}
+
+// Four lanes of bits to uniforms; the sign flip and 2^31 offset convert
+// unsigned to double exactly
+__attribute__((target("avx2")))
+inline __m256d uniform4(__m128i bits) {
+    __m256d value = _mm256_cvtepi32_pd(_mm_xor_si128(bits, _mm_set1_epi32(INT32_MIN)));
+    return _mm256_mul_pd(_mm256_add_pd(value, _mm256_set1_pd(2147483648.5)), _mm256_set1_pd(0x1p-32));
+}
+
+struct Lanes4 {
+    __m256d profit, budget, manHours, budgetViolation, manHoursViolation;
+};
+
+__attribute__((target("avx2")))
+void samplesAvx2(const ActiveColumns& c, uint64_t seed, size_t first, SampleOutcomes& out) {
+    const __m256i key = laneKeys(seed, first);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d hundred = _mm256_set1_pd(100.0);
+    Lanes4 lanes[2] = {{zero, zero, zero, zero, zero}, {zero, zero, zero, zero, zero}};
+
+    for (size_t j = 0; j < c.units.size(); ++j) {
+        __m256i costBits = mix32x8(_mm256_xor_si256(key, _mm256_set1_epi32(static_cast<int>(c.costKey[j]))));
+        __m256i percentBits = mix32x8(_mm256_xor_si256(key, _mm256_set1_epi32(static_cast<int>(c.percentKey[j]))));
+        __m256i perUnitBits = mix32x8(_mm256_xor_si256(key, _mm256_set1_epi32(static_cast<int>(c.perUnitKey[j]))));
+        __m256d units = _mm256_set1_pd(c.units[j]);
+        __m256d budgetMin = _mm256_set1_pd(c.budgetMin[j]);
+        __m256d budgetMax = _mm256_set1_pd(c.budgetMax[j]);
+        __m256d totalManHoursMax = _mm256_set1_pd(c.totalManHoursMax[j]);
+
+        for (int half = 0; half < 2; ++half) {
+            __m128i costHalf = half ? _mm256_extracti128_si256(costBits, 1) : _mm256_castsi256_si128(costBits);
+            __m128i percentHalf = half ? _mm256_extracti128_si256(percentBits, 1) : _mm256_castsi256_si128(percentBits);
+            __m128i perUnitHalf = half ? _mm256_extracti128_si256(perUnitBits, 1) : _mm256_castsi256_si128(perUnitBits);
+            __m256d cost = _mm256_add_pd(_mm256_set1_pd(c.costMin[j]),
+                                         _mm256_mul_pd(uniform4(costHalf), _mm256_set1_pd(c.costSpan[j])));
+            __m256d percent = _mm256_add_pd(_mm256_set1_pd(c.percentMin[j]),
+                                            _mm256_mul_pd(uniform4(percentHalf), _mm256_set1_pd(c.percentSpan[j])));
+            __m256d perUnit = _mm256_add_pd(_mm256_set1_pd(c.perUnitMin[j]),
+                                            _mm256_mul_pd(uniform4(perUnitHalf), _mm256_set1_pd(c.perUnitSpan[j])));
+            __m256d budgetUsed = _mm256_mul_pd(units, cost);
+            __m256d manHoursUsed = _mm256_mul_pd(units, perUnit);
+
+            Lanes4& lane = lanes[half];
+            lane.profit = _mm256_add_pd(lane.profit, _mm256_div_pd(_mm256_mul_pd(budgetUsed, percent), hundred));
+            lane.budget = _mm256_add_pd(lane.budget, budgetUsed);
+            lane.manHours = _mm256_add_pd(lane.manHours, manHoursUsed);
+            lane.budgetViolation = _mm256_add_pd(
+                lane.budgetViolation, _mm256_add_pd(_mm256_max_pd(_mm256_sub_pd(budgetMin, budgetUsed), zero),
+                                                    _mm256_max_pd(_mm256_sub_pd(budgetUsed, budgetMax), zero)));
+            lane.manHoursViolation = _mm256_add_pd(lane.manHoursViolation,
+                                                   _mm256_max_pd(_mm256_sub_pd(manHoursUsed, totalManHoursMax), zero));
+        }
+    }
+    for (int half = 0; half < 2; ++half) {
+        size_t at = first + 4 * half;
+        _mm256_storeu_pd(out.profit.data() + at, lanes[half].profit);
+        _mm256_storeu_pd(out.budget.data() + at, lanes[half].budget);
+        _mm256_storeu_pd(out.manHours.data() + at, lanes[half].manHours);
+        _mm256_storeu_pd(out.budgetViolation.data() + at, lanes[half].budgetViolation);
+        _mm256_storeu_pd(out.manHoursViolation.data() + at, lanes[half].manHoursViolation);
+    }
+}
+
+// The zero-masked forms avoid GCC's uninitialized warnings on the unmasked ones
+__attribute__((target("avx512f")))
+inline __m512d uniform8(__m256i bits) {
+    __m512d value = _mm512_maskz_cvtepu32_pd(0xFF, bits);
+    return _mm512_mul_pd(_mm512_add_pd(value, _mm512_set1_pd(0.5)), _mm512_set1_pd(0x1p-32));
+}
+
+// max(0, x) as the scalar path takes it
+__attribute__((target("avx512f")))
+inline __m512d positivePart(__m512d x) {
+    return _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(x, _mm512_setzero_pd(), _CMP_GT_OQ), x);
+}
+
+__attribute__((target("avx512f")))
+void samplesAvx512(const ActiveColumns& c, uint64_t seed, size_t first, SampleOutcomes& out) {
+    const __m256i key = laneKeys(seed, first);
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d hundred = _mm512_set1_pd(100.0);
+    __m512d profit = zero, budget = zero, manHours = zero, budgetViolation = zero, manHoursViolation = zero;
+
+    for (size_t j = 0; j < c.units.size(); ++j) {
+        __m256i costBits = mix32x8(_mm256_xor_si256(key, _mm256_set1_epi32(static_cast<int>(c.costKey[j]))));
+        __m256i percentBits = mix32x8(_mm256_xor_si256(key, _mm256_set1_epi32(static_cast<int>(c.percentKey[j]))));
+        __m256i perUnitBits = mix32x8(_mm256_xor_si256(key, _mm256_set1_epi32(static_cast<int>(c.perUnitKey[j]))));
+        __m512d units = _mm512_set1_pd(c.units[j]);
+        __m512d cost = _mm512_add_pd(_mm512_set1_pd(c.costMin[j]),
+                                     _mm512_mul_pd(uniform8(costBits), _mm512_set1_pd(c.costSpan[j])));
+        __m512d percent = _mm512_add_pd(_mm512_set1_pd(c.percentMin[j]),
+                                        _mm512_mul_pd(uniform8(percentBits), _mm512_set1_pd(c.percentSpan[j])));
+        __m512d perUnit = _mm512_add_pd(_mm512_set1_pd(c.perUnitMin[j]),
+                                        _mm512_mul_pd(uniform8(perUnitBits), _mm512_set1_pd(c.perUnitSpan[j])));
+        __m512d budgetUsed = _mm512_mul_pd(units, cost);
+        __m512d manHoursUsed = _mm512_mul_pd(units, perUnit);
+
+        profit = _mm512_add_pd(profit, _mm512_div_pd(_mm512_mul_pd(budgetUsed, percent), hundred));
+        budget = _mm512_add_pd(budget, budgetUsed);
+        manHours = _mm512_add_pd(manHours, manHoursUsed);
+        budgetViolation = _mm512_add_pd(
+            budgetViolation, _mm512_add_pd(positivePart(_mm512_sub_pd(_mm512_set1_pd(c.budgetMin[j]), budgetUsed)),
+                                           positivePart(_mm512_sub_pd(budgetUsed, _mm512_set1_pd(c.budgetMax[j])))));
+        manHoursViolation = _mm512_add_pd(
+            manHoursViolation, positivePart(_mm512_sub_pd(manHoursUsed, _mm512_set1_pd(c.totalManHoursMax[j]))));
+    }
+    _mm512_storeu_pd(out.profit.data() + first, profit);
+    _mm512_storeu_pd(out.budget.data() + first, budget);
+    _mm512_storeu_pd(out.manHours.data() + first, manHours);
+    _mm512_storeu_pd(out.budgetViolation.data() + first, budgetViolation);
+    _mm512_storeu_pd(out.manHoursViolation.data() + first, manHoursViolation);
+}
+
+#endif
+
+// Samples [begin, end): full groups of kLanes through the vector kernel
+void evaluateBlock(const ActiveColumns& c, uint64_t seed, size_t begin, size_t end, SampleOutcomes& out) {
+    size_t sample = begin;
+#if defined(__x86_64__)
+    for (; kIsa != Isa::Scalar && sample + kLanes <= end; sample += kLanes) {
+        if (kIsa == Isa::Avx512) {
+            samplesAvx512(c, seed, sample, out);
+        } else {
+            samplesAvx2(c, seed, sample, out);
+        }
+    }
+#endif
+    for (; sample < end; ++sample) {
+        sampleScalar(c, seed, sample, out);
+    }
+}
+
+double percentile(const std::vector<double>& sorted, double share) {
+    // Linear interpolation between the closest ranks
+    double position = share * static_cast<double>(sorted.size() - 1);
+    size_t below = static_cast<size_t>(position);
+    size_t above = std::min(below + 1, sorted.size() - 1);
+    return sorted[below] + (position - static_cast<double>(below)) * (sorted[above] - sorted[below]);
+}
+
+void writeDistribution(std::ostream& out, const char* name, const Distribution& d) {
+    out << jsonString(name) << ":{\"mean\":" << jsonNumber(d.mean)
+        << ",\"stddev\":" << jsonNumber(d.stddev)
+        << ",\"min\":" << jsonNumber(d.min)
+        << ",\"p5\":" << jsonNumber(d.p5)
+        << ",\"p25\":" << jsonNumber(d.p25)
+        << ",\"p50\":" << jsonNumber(d.p50)
+        << ",\"p75\":" << jsonNumber(d.p75)
+        << ",\"p95\":" << jsonNumber(d.p95)
+        << ",\"max\":" << jsonNumber(d.max) << "}";
+}
+
+} // namespace
+
+void drawSample(const PlanColumns& plan, uint64_t seed, size_t sample,
+                double* cost, double* profitPercent, double* manHourPerUnit) {
+    uint32_t key = sampleKey(seed, sample);
+    for (size_t i = 0; i < plan.count; ++i) {
+        cost[i] = draw(key, drawKey(i, 0), plan.costMin[i], plan.costMax[i] - plan.costMin[i]);
+        profitPercent[i] = draw(key, drawKey(i, 1), plan.profitMin[i], plan.profitMax[i] - plan.profitMin[i]);
+        manHourPerUnit[i] = draw(key, drawKey(i, 2), plan.manHourPerUnitMin[i],
+                                 plan.manHourPerUnitMax[i] - plan.manHourPerUnitMin[i]);
+    }
+}
+
+SampleOutcomes evaluatePlanSamples(const PlanColumns& plan, const GlobalConstraints& globalConstraints,
+                                   uint64_t seed, size_t samples, unsigned threads) {
+    ActiveColumns active = gatherActive(plan);
+    SampleOutcomes out;
+    out.profit.resize(samples);
+    out.budget.resize(samples);
+    out.manHours.resize(samples);
+    out.budgetViolation.resize(samples);
+    out.manHoursViolation.resize(samples);
+
+    // Every sample owns its slots, so blocks may finish in any order
+    size_t blocks = (samples + kSampleBlock - 1) / kSampleBlock;
+    auto runBlock = [&](size_t b) {
+        evaluateBlock(active, seed, b * kSampleBlock, std::min(samples, (b + 1) * kSampleBlock), out);
+    };
+    if (blocks > 1 && threads != 1 && ThreadPool::currentWorker() < 0) {
+        ThreadPool pool(threads);
+        pool.parallelFor(blocks, runBlock);
+    } else {
+        for (size_t b = 0; b < blocks; ++b) {
+            runBlock(b);
+        }
+    }
+
+    for (size_t s = 0; s < samples; ++s) {
+        out.budgetViolation[s] += active.idleBudgetViolation +
+                                  std::max(0.0, globalConstraints.budgetMin - out.budget[s]) +
+                                  std::max(0.0, out.budget[s] - globalConstraints.budgetMax);
+        out.manHoursViolation[s] += active.idleManHoursViolation +
+                                    std::max(0.0, out.manHours[s] - globalConstraints.manHoursMax);
+    }
+    return out;
+}
+
+const char* monteCarloKernelIsa() {
+    switch (kIsa) {
+        case Isa::Avx512: return "avx512";
+        case Isa::Avx2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+Distribution summarizeDistribution(std::vector<double> values) {
+    Distribution d;
+    if (values.empty()) return d;
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double value : values) sum += value;
+    d.mean = sum / static_cast<double>(values.size());
+    double squares = 0.0;
+    for (double value : values) squares += (value - d.mean) * (value - d.mean);
+    d.stddev = values.size() > 1 ? std::sqrt(squares / static_cast<double>(values.size() - 1)) : 0.0;
+    d.min = values.front();
+    d.max = values.back();
+    d.p5 = percentile(values, 0.05);
+    d.p25 = percentile(values, 0.25);
+    d.p50 = percentile(values, 0.50);
+    d.p75 = percentile(values, 0.75);
+    d.p95 = percentile(values, 0.95);
+    return d;
+}
+
+MonteCarloReport summarizeSamples(const SampleOutcomes& outcomes, const GlobalConstraints& globalConstraints) {
+    MonteCarloReport report;
+    size_t samples = outcomes.profit.size();
+    report.samples = samples;
+    report.profit = summarizeDistribution(outcomes.profit);
+    report.budget = summarizeDistribution(outcomes.budget);
+    report.manHours = summarizeDistribution(outcomes.manHours);
+    report.budgetViolation = summarizeDistribution(outcomes.budgetViolation);
+    report.manHoursViolation = summarizeDistribution(outcomes.manHoursViolation);
+    if (samples == 0) return report;
+
+    size_t violated = 0, globalBudget = 0, globalManHours = 0;
+    for (size_t s = 0; s < samples; ++s) {
+        violated += outcomes.budgetViolation[s] > 0.0 || outcomes.manHoursViolation[s] > 0.0;
+        globalBudget += outcomes.budget[s] < globalConstraints.budgetMin || outcomes.budget[s] > globalConstraints.budgetMax;
+        globalManHours += outcomes.manHours[s] > globalConstraints.manHoursMax;
+    }
+    report.violatedShare = static_cast<double>(violated) / static_cast<double>(samples);
+    report.globalBudgetViolatedShare = static_cast<double>(globalBudget) / static_cast<double>(samples);
+    report.globalManHoursViolatedShare = static_cast<double>(globalManHours) / static_cast<double>(samples);
+    return report;
+}
+
+void writeMonteCarloReport(const MonteCarloReport& report, std::ostream& out) {
+    out << "{\"samples\":" << report.samples
+        << ",\"seed\":" << report.seed
+        << ",\"evaluate_millis\":" << jsonNumber(report.evaluateMillis)
+        << ",\"kernel_isa\":" << jsonString(monteCarloKernelIsa())
+        << ",\"violated_share\":" << jsonNumber(report.violatedShare)
+        << ",\"global_budget_violated_share\":" << jsonNumber(report.globalBudgetViolatedShare)
+        << ",\"global_man_hours_violated_share\":" << jsonNumber(report.globalManHoursViolatedShare)
+        << ",\n";
+    writeDistribution(out, "profit", report.profit);
+    out << ",\n";
+    writeDistribution(out, "budget_used", report.budget);
+    out << ",\n";
+    writeDistribution(out, "man_hours_used", report.manHours);
+    out << ",\n";
+    writeDistribution(out, "budget_violation", report.budgetViolation);
+    out << ",\n";
+    writeDistribution(out, "man_hours_violation", report.manHoursViolation);
+    out << ",\n\"resolve\":{\"samples\":" << report.resolved
+        << ",\"optimal\":" << report.resolvedOptimal
+        << ",\"iterations\":" << report.resolveIterations
+        << ",\"millis\":" << jsonNumber(report.resolveMillis) << ",";
+    writeDistribution(out, "profit", report.resolvedProfit);
+    out << ",";
+    writeDistribution(out, "profit_gap", report.profitGap);
+    out << "}}\n";
+}
@@ -0,0 +1,102 @@
+// monte_carlo.h
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+#include "input.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Requested Monte Carlo run over the product ranges
+struct MonteCarloConfig {
+    size_t samples = 0;         // Realizations evaluated against the plan, 0 = off
+    uint64_t seed = 1;
+    size_t resolveSamples = 0;  // The first samples are also re-optimized from the midpoint basis
+    std::string outputFile;     // JSON report, empty = print only
+};
+
+// The plan and the ranges it is evaluated against, one entry per product
+struct PlanColumns {
+    size_t count = 0;
+    const double* units = nullptr;
+    const double* costMin = nullptr;
+    const double* costMax = nullptr;
+    const double* profitMin = nullptr;
+    const double* profitMax = nullptr;
+    const double* manHourPerUnitMin = nullptr;
+    const double* manHourPerUnitMax = nullptr;
+    const double* budgetMin = nullptr;
+    const double* budgetMax = nullptr;
+    const double* totalManHoursMax = nullptr;
+};
+
+// Outcome of the plan under every sampled realization, indexed by sample.
+// Violations are the amounts by which product and global rows are exceeded.
+struct SampleOutcomes {
+    std::vector<double> profit;
+    std::vector<double> budget;
+    std::vector<double> manHours;
+    std::vector<double> budgetViolation;
+    std::vector<double> manHoursViolation;
+};
+
+// Cost, profit % and man-hours per unit of every product in one sample.
+// Each value is drawn uniformly from its range by a counter-based generator
+// keyed on (seed, sample, product), so any sample can be reproduced alone
+// and results do not depend on the thread count or instruction set.
+void drawSample(const PlanColumns& plan, uint64_t seed, size_t sample,
+                double* cost, double* profitPercent, double* manHourPerUnit);
+
+// Evaluate the plan under samples [0, samples) with a vectorized kernel
+// (AVX-512 or AVX2 when the CPU has them) spread across threads
+SampleOutcomes evaluatePlanSamples(const PlanColumns& plan, const GlobalConstraints& globalConstraints,
+                                   uint64_t seed, size_t samples, unsigned threads = 0);
+
+// Instruction set the sample kernel uses on this CPU
+const char* monteCarloKernelIsa();
+
+struct Distribution {
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double p5 = 0.0;
+    double p25 = 0.0;
+    double p50 = 0.0;
+    double p75 = 0.0;
+    double p95 = 0.0;
+};
+
+Distribution summarizeDistribution(std::vector<double> values);
+
+struct MonteCarloReport {
+    size_t samples = 0;
+    uint64_t seed = 0;
+    double evaluateMillis = 0.0;
+    Distribution profit;
+    Distribution budget;
+    Distribution manHours;
+    Distribution budgetViolation;
+    Distribution manHoursViolation;
+    double violatedShare = 0.0;              // Samples exceeding any row
+    double globalBudgetViolatedShare = 0.0;
+    double globalManHoursViolatedShare = 0.0;
+
+    // Re-optimized samples: the best plan had the sample been known
+    size_t resolved = 0;
+    size_t resolvedOptimal = 0;
+    long resolveIterations = 0;
+    double resolveMillis = 0.0;
+    Distribution resolvedProfit;
+    Distribution profitGap;                  // Re-optimized profit minus the plan's profit
+};
+
+// Distributions and violation shares of evaluated samples
+MonteCarloReport summarizeSamples(const SampleOutcomes& outcomes, const GlobalConstraints& globalConstraints);
+
+// Write the report as a single JSON document
+void writeMonteCarloReport(const MonteCarloReport& report, std::ostream& out);
+
+#endif // MONTE_CARLO_H
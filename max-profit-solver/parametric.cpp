@@ -0,0 +1,208 @@
+#include "parametric.h"
+#include "json_util.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+struct Sample {
+    bool feasible = false;
+    double value = 0.0;
+    double slope = 0.0;  // d(value)/d(theta) at this theta
+};
+
+// Moves the target to theta and re-solves from the current basis
+class Evaluator {
+public:
+    Evaluator(ClpSimplex& model, const ParametricTarget& target, LpAlgorithm algorithm, ParametricCurve& curve)
+        : model(model), target(target), algorithm(algorithm), curve(curve) {
+        for (size_t column = 0; column < target.direction.size(); ++column) {
+            if (target.direction[column] != 0.0) changedColumns.push_back(static_cast<int>(column));
+        }
+    }
+
+    Sample operator()(double theta) {
+        if (target.kind == ParametricTarget::Objective) {
+            for (int column : changedColumns) {
+                model.setObjectiveCoefficient(column, target.baseCosts[column] +
+                                                      (theta - target.baseTheta) * target.direction[column]);
+            }
+            // Still primal feasible after a cost change
+            runLpAlgorithm(model, algorithm, WarmStart::Other, false);
+        } else {
+            if (target.kind == ParametricTarget::RowUpper) {
+                model.setRowUpper(target.row, theta);
+            } else {
+                model.setRowLower(target.row, theta);
+            }
+            // Still dual feasible after a bound change
+            runLpAlgorithm(model, algorithm, WarmStart::Bounds, false);
+        }
+        ++curve.solves;
+        curve.iterations += model.numberIterations();
+
+        Sample sample;
+        if (model.status() != 0) return sample;
+
+        sample.feasible = true;
+        sample.value = model.objectiveValue();
+        if (target.kind == ParametricTarget::Objective) {
+            const double* solution = model.getColSolution();
+            for (int column : changedColumns) {
+                sample.slope += target.direction[column] * solution[column];
+            }
+        } else {
+            // The row dual prices the moved bound only while that bound is binding
+            double activity = model.primalRowSolution()[target.row];
+            double tolerance = 1e-7 * std::max(1.0, std::fabs(theta));
+            sample.slope = std::fabs(activity - theta) <= tolerance ? model.dualRowSolution()[target.row] : 0.0;
+        }
+        return sample;
+    }
+
+private:
+    ClpSimplex& model;
+    const ParametricTarget& target;
+    LpAlgorithm algorithm;
+    ParametricCurve& curve;
+    std::vector<int> changedColumns;
+};
+
+bool nearlyEqual(double a, double b, double scale) {
+    return std::fabs(a - b) <= 1e-9 * std::max(1.0, scale) + 1e-9;
+}
+
+const int kMaxSolves = 100000;
+
+} // namespace
+
+ParametricCurve traceParametricCurve(ClpSimplex& model, const ParametricTarget& target,
+                                     double from, double to, LpAlgorithm algorithm) {
+    if (from > to) std::swap(from, to);
+
+    ParametricCurve curve;
+    curve.target = target.name;
+    Evaluator evaluate(model, target, algorithm, curve);
+    std::map<double, Sample> samples;
+    samples[from] = evaluate(from);
+    samples[to] = evaluate(to);
+
+    // The feasible thetas form an interval: bisect towards it from infeasible ends
+    double lo = from, hi = to;
+    if (!samples[from].feasible || !samples[to].feasible) {
+        double anchor = from;
+        bool found = samples[from].feasible || samples[to].feasible;
+        if (found) {
+            anchor = samples[from].feasible ? from : to;
+        } else {
+            anchor = (from + to) / 2.0;
+            Sample middle = evaluate(anchor);
+            found = middle.feasible;
+            if (found) samples[anchor] = middle;
+        }
+        if (!found) {
+            throw std::runtime_error("Parametric sweep of " + curve.target + " is infeasible over the whole range");
+        }
+
+        auto shrink = [&](double infeasible) {
+            double feasible = anchor;
+            for (int step = 0; step < 60 && !nearlyEqual(feasible, infeasible, std::fabs(feasible)); ++step) {
+                double middle = (feasible + infeasible) / 2.0;
+                Sample sample = evaluate(middle);
+                if (sample.feasible) {
+                    feasible = middle;
+                    samples[middle] = sample;
+                } else {
+                    infeasible = middle;
+                }
+            }
+            return feasible;
+        };
+        if (!samples[from].feasible) lo = shrink(from);
+        if (!samples[to].feasible) hi = shrink(to);
+    }
+    curve.feasibleFrom = lo;
+    curve.feasibleTo = hi;
+
+    // Sandwich the curve between tangents: where the tangents at a and b meet
+    // either the curve touches both (a breakpoint) or there is another piece
+    std::vector<std::pair<double, double>> pending;
+    {
+        std::vector<double> thetas;
+        for (const auto& [theta, sample] : samples) {
+            if (sample.feasible && theta >= lo && theta <= hi) thetas.push_back(theta);
+        }
+        for (size_t i = 0; i + 1 < thetas.size(); ++i) pending.emplace_back(thetas[i], thetas[i + 1]);
+    }
+
+    while (!pending.empty() && curve.solves < kMaxSolves) {
+        auto [a, b] = pending.back();
+        pending.pop_back();
+        const Sample left = samples[a];
+        const Sample right = samples[b];
+        double scale = std::max({std::fabs(left.value), std::fabs(right.value), std::fabs(a), std::fabs(b)});
+        if (nearlyEqual(a, b, std::max(std::fabs(a), std::fabs(b)))) continue;
+
+        double chordSlope = (right.value - left.value) / (b - a);
+        if (nearlyEqual(left.slope, chordSlope, std::fabs(chordSlope)) &&
+            nearlyEqual(right.slope, chordSlope, std::fabs(chordSlope))) {
+            continue;  // Both tangents are the chord: one linear piece
+        }
+
+        double theta = (a + b) / 2.0;
+        bool atIntersection = false;
+        double slopeGap = left.slope - right.slope;
+        if (std::fabs(slopeGap) > 1e-12) {
+            double intersection = (right.value - left.value + left.slope * a - right.slope * b) / slopeGap;
+            if (intersection > a && intersection < b) {
+                theta = intersection;
+                atIntersection = true;
+            }
+        }
+
+        Sample middle = evaluate(theta);
+        if (!middle.feasible) continue;
+        samples[theta] = middle;
+
+        double predicted = atIntersection ? left.value + left.slope * (theta - a)
+                                          : left.value + chordSlope * (theta - a);
+        if (nearlyEqual(middle.value, predicted, scale)) {
+            continue;  // Breakpoint at the intersection, or a linear piece
+        }
+        pending.emplace_back(a, theta);
+        pending.emplace_back(theta, b);
+    }
+
+    // Keep the endpoints and every point where the slope changes
+    std::vector<CurvePoint> points;
+    for (const auto& [theta, sample] : samples) {
+        if (sample.feasible && theta >= lo && theta <= hi) points.push_back({theta, sample.value});
+    }
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (i > 0 && i + 1 < points.size() && !curve.breakpoints.empty()) {
+            const CurvePoint& previous = curve.breakpoints.back();
+            const CurvePoint& next = points[i + 1];
+            double before = (points[i].value - previous.value) / (points[i].theta - previous.theta);
+            double after = (next.value - points[i].value) / (next.theta - points[i].theta);
+            if (nearlyEqual(before, after, std::max(std::fabs(before), std::fabs(after)))) continue;
+        }
+        curve.breakpoints.push_back(points[i]);
+    }
+    return curve;
+}
+
+void writeParametricCurve(const ParametricCurve& curve, std::ostream& out) {
+    out << "{\"target\":" << jsonString(curve.target)
+        << ",\"feasible_from\":" << jsonNumber(curve.feasibleFrom)
+        << ",\"feasible_to\":" << jsonNumber(curve.feasibleTo)
+        << ",\"solves\":" << curve.solves
+        << ",\"iterations\":" << curve.iterations
+        << ",\"breakpoints\":[";
+    for (size_t i = 0; i < curve.breakpoints.size(); ++i) {
+        out << (i ? "," : "") << "{\"theta\":" << jsonNumber(curve.breakpoints[i].theta)
+            << ",\"value\":" << jsonNumber(curve.breakpoints[i].value) << "}";
+    }
+    out << "]}\n";
+}
@@ -0,0 +1,57 @@
+// parametric.h
+#ifndef PARAMETRIC_H
+#define PARAMETRIC_H
+
+#include "lp_algorithm.h"
+#include <ClpSimplex.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Requested sweep, e.g. target "global_budget" from 12000 to 30000
+struct ParametricSweep {
+    std::string target;     // global_budget, global_man_hours, row:N, profit_weight, resource_weight, budget_weight
+    double from = 0.0;
+    double to = 0.0;
+    std::string outputFile; // JSON curve, empty = print only
+};
+
+// The model quantity moved by theta
+struct ParametricTarget {
+    enum Kind { RowUpper, RowLower, Objective };
+    std::string name;
+    Kind kind = RowUpper;
+    int row = -1;                    // Row for RowUpper/RowLower, theta is the bound itself
+    std::vector<double> baseCosts;   // Objective: costs = baseCosts + (theta - baseTheta) * direction
+    std::vector<double> direction;
+    double baseTheta = 0.0;
+};
+
+struct CurvePoint {
+    double theta;
+    double value;
+};
+
+// Optimal objective as a piecewise-linear function of theta
+struct ParametricCurve {
+    std::string target;
+    std::vector<CurvePoint> breakpoints;  // Sorted by theta, endpoints included
+    double feasibleFrom = 0.0;            // Sub-range where the model stays feasible
+    double feasibleTo = 0.0;
+    int solves = 0;
+    int iterations = 0;
+};
+
+// Trace the exact value curve over [from, to]. The optimal value is convex
+// (RHS) or concave (objective) and piecewise linear in theta, so evaluating
+// value and slope at two points and re-solving only where their tangents
+// meet finds every breakpoint. Each re-solve warm-starts from the previous
+// basis with algorithm; auto picks dual simplex for bound moves and primal
+// simplex for objective moves. The model is solved in place and should
+// start from an optimal basis.
+ParametricCurve traceParametricCurve(ClpSimplex& model, const ParametricTarget& target,
+                                     double from, double to, LpAlgorithm algorithm);
+
+void writeParametricCurve(const ParametricCurve& curve, std::ostream& out);
+
+#endif // PARAMETRIC_H
@@ -0,0 +1,72 @@
+#include "product_table.h"
+#include <stdexcept>
+#include <utility>
+
+size_t ProductTable::fieldIndex(double Product::* field) {
+    for (size_t i = 0; i < kProductFieldCount; ++i) {
+        if (kProductFields[i] == field) {
+            return i;
+        }
+    }
+    throw std::invalid_argument("Unknown product field");
+}
+
+void ProductTable::reserve(size_t count) {
+    names.reserve(count);
+    for (auto& column : columns) {
+        column.reserve(count);
+    }
+    indexByName.reserve(count);
+}
+
+size_t ProductTable::insertOrAssign(const Product& product) {
+    auto [it, inserted] = indexByName.try_emplace(product.name, names.size());
+    if (inserted) {
+        names.push_back(product.name);
+        for (size_t i = 0; i < kProductFieldCount; ++i) {
+            columns[i].push_back(product.*kProductFields[i]);
+        }
+    } else {
+        set(it->second, product);
+    }
+    return it->second;
+}
+
+void ProductTable::assignColumns(std::vector<std::string> productNames, const double* const* fieldColumns) {
+    std::unordered_map<std::string, size_t> index;
+    index.reserve(productNames.size());
+    for (size_t i = 0; i < productNames.size(); ++i) {
+        if (!index.try_emplace(productNames[i], i).second) {
+            throw std::invalid_argument("Duplicate product name: " + productNames[i]);
+        }
+    }
+    for (size_t i = 0; i < kProductFieldCount; ++i) {
+        columns[i].assign(fieldColumns[i], fieldColumns[i] + productNames.size());
+    }
+    names = std::move(productNames);
+    indexByName = std::move(index);
+}
+
+size_t ProductTable::find(const std::string& name) const {
+    auto it = indexByName.find(name);
+    return it == indexByName.end() ? npos : it->second;
+}
+
+Product ProductTable::get(size_t index) const {
+    Product product;
+    product.name = names[index];
+    for (size_t i = 0; i < kProductFieldCount; ++i) {
+        product.*kProductFields[i] = columns[i][index];
+    }
+    return product;
+}
+
+void ProductTable::set(size_t index, const Product& product) {
+    for (size_t i = 0; i < kProductFieldCount; ++i) {
+        columns[i][index] = product.*kProductFields[i];
+    }
+}
+
+const std::vector<double>& ProductTable::column(double Product::* field) const {
+    return columns[fieldIndex(field)];
+}
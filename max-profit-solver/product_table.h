@@ -0,0 +1,69 @@
+// product_table.h
+#ifndef PRODUCT_TABLE_H
+#define PRODUCT_TABLE_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Product-specific constraints
+struct Product {
+    std::string name;
+    double costMin, costMax;
+    double profitMin, profitMax;
+    double demandMin, demandMax;
+    double budgetMin, budgetMax;
+    double manHourPerUnitMin, manHourPerUnitMax;
+    double totalManHoursMin, totalManHoursMax;
+};
+
+// Range fields of Product in table column order
+inline constexpr double Product::* kProductFields[] = {
+    &Product::costMin, &Product::costMax,
+    &Product::profitMin, &Product::profitMax,
+    &Product::demandMin, &Product::demandMax,
+    &Product::budgetMin, &Product::budgetMax,
+    &Product::manHourPerUnitMin, &Product::manHourPerUnitMax,
+    &Product::totalManHoursMin, &Product::totalManHoursMax,
+};
+inline constexpr size_t kProductFieldCount = sizeof(kProductFields) / sizeof(kProductFields[0]);
+
+// Products stored column by column in insertion order. Index i is product
+// i everywhere, including LP column i, and every range field is one
+// contiguous array so whole-catalog passes are sequential scans.
+class ProductTable {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    size_t size() const { return names.size(); }
+    bool empty() const { return names.empty(); }
+    void reserve(size_t count);
+
+    // Append a product, or overwrite the product with the same name in place
+    size_t insertOrAssign(const Product& product);
+
+    // Replace the contents with products given column by column, one array of
+    // productNames.size() values per field in kProductFields order. Throws
+    // std::invalid_argument on a repeated name.
+    void assignColumns(std::vector<std::string> productNames, const double* const* fieldColumns);
+
+    // Index of the named product, npos if absent
+    size_t find(const std::string& name) const;
+
+    const std::string& name(size_t index) const { return names[index]; }
+    Product get(size_t index) const;
+    void set(size_t index, const Product& product);  // Keeps the stored name
+
+    // One range field of every product, e.g. column(&Product::costMin)
+    const std::vector<double>& column(double Product::* field) const;
+
+private:
+    std::vector<std::string> names;
+    std::vector<double> columns[kProductFieldCount];
+    std::unordered_map<std::string, size_t> indexByName;
+
+    static size_t fieldIndex(double Product::* field);
+};
+
+#endif // PRODUCT_TABLE_H
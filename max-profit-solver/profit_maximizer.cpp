@@ -1,27 +1,367 @@
+#include "batch.h"
+#include "catalog_generator.h"
 #include "input.h"
+#include "metrics.h"
+#include "model_file.h"
+#include "rolling_horizon.h"
+#include "server.h"
+#include "site_decomposition.h"
 #include "solver.h"
+#include <algorithm>
+#include <initializer_list>
 #include <iostream>
+#include <string>
 #include <vector>
 
-int main() {
-    const std::string inputFile = "input.config";
-    std::unordered_map<std::string, Product> products;
+static void printUsage(const char* program) {
+    std::cerr << "Usage:\n"
+              << "  " << program << " [config] [--threads N] [--engine auto|clp] [--algorithm auto|primal|dual|barrier]\n"
+              << "      [--presolve] [--lexicographic] [--lexicographic-tolerance T] [--sensitivity-report FILE]\n"
+              << "      [--integer] [--integer-gap G] [--integer-max-nodes N] [--site-max-iterations N]\n"
+              << "      [--parametric TARGET:FROM:TO] [--parametric-output FILE]\n"
+              << "      [--metrics FILE] [--metrics-format json|prometheus]\n"
+              << "      [--results FILE] [--sensitivity-results FILE] [--results-format csv|ndjson|binary]\n"
+              << "      [--background-writer] [--top K] [--cache DIR] [--cache-max-mb N]\n"
+              << "      [--monte-carlo N] [--monte-carlo-seed S] [--monte-carlo-resolve M] [--monte-carlo-output FILE]\n"
+              << "      Solve a single configuration or compiled model (default: input.config)\n"
+              << "      TARGET: global_budget, global_man_hours, row:N, profit_weight, resource_weight, budget_weight\n"
+              << "  " << program << " compile <config> <model>\n"
+              << "      Compile a configuration into a binary model that loads without parsing\n"
+              << "  " << program << " generate <products> <config> [--tightness T] [--seed S]\n"
+              << "      Write a deterministic synthetic configuration, T in [0, 1] tightens the global rows\n"
+              << "  " << program << " batch <directory|manifest> [--threads N] [--output FILE]\n"
+              << "      [--metrics FILE] [--metrics-format json|prometheus] [--cache DIR] [--cache-max-mb N]\n"
+              << "      [--algorithm auto|primal|dual|barrier] [--presolve]\n"
+              << "      Solve many configurations in parallel, one JSON result line per scenario\n"
+              << "  " << program << " serve [config] [--socket PATH]\n"
+              << "      Keep the model loaded and apply edits read line by line from stdin or a Unix socket\n"
+              << "  --metrics writes phase wall/CPU times, solve counters and peak RSS when the run ends\n"
+              << "  --algorithm picks the Clp algorithm; auto keeps simplex on a warm basis and uses barrier\n"
+              << "      (with crossover) for large sparse cold solves, dual simplex otherwise. It and --presolve\n"
+              << "      only take effect where Clp runs: with --engine clp, for models the fast path does not\n"
+              << "      take, and in the re-solves of sensitivity, parametric, integer and serve runs\n"
+              << "  --lexicographic optimizes each objective rank in turn, locking earlier optima within the\n"
+              << "      relative tolerance (default 1e-6), instead of blending ranks into one objective\n"
+              << "  --integer produces whole units by parallel branch-and-bound, stopping within the relative\n"
+              << "      gap G (default 1e-4) or after N nodes (default 100000)\n"
+              << "  --site-max-iterations caps the pricing rounds of configs with [Site:NAME] sections, which\n"
+              << "      are solved by decomposition over the sites (default 200); they only take --threads,\n"
+              << "      --algorithm, --site-max-iterations and --metrics\n"
+              << "  configs with a [Horizon] section are planned by rolling horizon, window by window; they only\n"
+              << "      take --algorithm, --presolve, --results (one row per period and product, with\n"
+              << "      --results-format and --background-writer) and --metrics\n"
+              << "  --cache reuses solutions of identical inputs and warm starts Clp from the basis of the same\n"
+              << "      catalog; the fast path ignores that basis, so warm starts only happen with --engine clp\n"
+              << "      or models the fast path does not take\n"
+              << "  --monte-carlo evaluates the plan under N draws from the product ranges and reports profit,\n"
+              << "      usage and violation distributions; the first M draws are also re-optimized\n";
+}
+
+// First of the given flags that a kind of config cannot honor, empty when
+// every flag is supported
+static std::string unsupportedFlag(const std::vector<std::string>& flags,
+                                   std::initializer_list<std::string> supported) {
+    for (const std::string& flag : flags) {
+        if (std::find(supported.begin(), supported.end(), flag) == supported.end()) {
+            return flag;
+        }
+    }
+    return std::string();
+}
+
+// Handle --metrics and --metrics-format at argv[i], false for any other
+// argument or an unknown format
+static bool parseMetricsArg(int argc, char* argv[], int& i, std::string& metricsFile, MetricsFormat& format) {
+    std::string arg = argv[i];
+    if (arg == "--metrics" && i + 1 < argc) {
+        metricsFile = argv[++i];
+        return true;
+    }
+    if (arg == "--metrics-format" && i + 1 < argc) {
+        std::string name = argv[++i];
+        format = name == "prometheus" ? MetricsFormat::Prometheus : MetricsFormat::Json;
+        return name == "json" || name == "prometheus";
+    }
+    return false;
+}
+
+// Write the metrics file if one was requested, keeping the exit code
+static int finishWithMetrics(int exitCode, const std::string& metricsFile, MetricsFormat format) {
+    if (metricsFile.empty()) {
+        return exitCode;
+    }
+    try {
+        writeMetrics(metricsFile, format);
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return exitCode == 0 ? 1 : exitCode;
+    }
+    return exitCode;
+}
+
+static int runBatchCommand(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    BatchOptions options;
+    options.source = argv[2];
+    options.outputFile = "batch_results.jsonl";
+    std::string metricsFile;
+    MetricsFormat metricsFormat = MetricsFormat::Json;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (parseMetricsArg(argc, argv, i, metricsFile, metricsFormat)) {
+            continue;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--output" && i + 1 < argc) {
+            options.outputFile = argv[++i];
+        } else if (arg == "--cache" && i + 1 < argc) {
+            options.cacheDir = argv[++i];
+        } else if (arg == "--cache-max-mb" && i + 1 < argc) {
+            options.cacheMaxBytes = std::stoull(argv[++i]) << 20;
+        } else if (arg == "--algorithm" && i + 1 < argc) {
+            if (!parseLpAlgorithm(argv[++i], options.algorithm)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--presolve") {
+            options.presolve = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!metricsFile.empty()) {
+        enableMetrics();
+    }
+    int exitCode = 1;
+    try {
+        exitCode = runBatch(options) == 0 ? 0 : 2;
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+    }
+    return finishWithMetrics(exitCode, metricsFile, metricsFormat);
+}
+
+static int runCompileCommand(int argc, char* argv[]) {
+    if (argc != 4) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        GlobalConstraints globalConstraints{};
+        std::vector<Objective> objectives;
+        auto products = parseInputConfig(argv[2], globalConstraints, objectives);
+        writeCompiledModel(argv[3], products, globalConstraints, objectives);
+        std::cout << "Compiled " << products.size() << " products into " << argv[3] << "\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+static int runGenerateCommand(int argc, char* argv[]) {
+    if (argc < 4) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        CatalogSpec spec;
+        spec.products = std::stoul(argv[2]);
+        for (int i = 4; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--tightness" && i + 1 < argc) {
+                spec.tightness = std::stod(argv[++i]);
+            } else if (arg == "--seed" && i + 1 < argc) {
+                spec.seed = std::stoull(argv[++i]);
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        ProductTable products = generateCatalog(spec);
+        writeInputConfig(argv[3], products, generateGlobals(products, spec.tightness), defaultObjectives());
+        std::cout << "Generated " << products.size() << " products into " << argv[3] << "\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+static int runServeCommand(int argc, char* argv[]) {
+    ServerOptions options;
+    bool inputGiven = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            options.socketPath = argv[++i];
+        } else if (arg[0] != '-' && !inputGiven) {
+            options.inputFile = arg;
+            inputGiven = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    try {
+        return runServer(options);
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "batch") {
+        return runBatchCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "compile") {
+        return runCompileCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "generate") {
+        return runGenerateCommand(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "serve") {
+        return runServeCommand(argc, argv);
+    }
+    std::string inputFile = "input.config";
+    SolverOptions solverOptions;
+    DecompositionOptions decompositionOptions;
+    std::string metricsFile;
+    MetricsFormat metricsFormat = MetricsFormat::Json;
+    bool inputGiven = false;
+    std::vector<std::string> flags;  // Every option given, checked against what the config supports
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg[0] == '-') {
+            flags.push_back(arg);
+        }
+        if (parseMetricsArg(argc, argv, i, metricsFile, metricsFormat)) {
+            continue;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            solverOptions.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--engine" && i + 1 < argc) {
+            std::string engine = argv[++i];
+            if (engine != "auto" && engine != "clp") {
+                printUsage(argv[0]);
+                return 1;
+            }
+            solverOptions.engine = engine == "clp" ? SolverEngine::Clp : SolverEngine::Auto;
+        } else if (arg == "--algorithm" && i + 1 < argc) {
+            if (!parseLpAlgorithm(argv[++i], solverOptions.algorithm)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--presolve") {
+            solverOptions.presolve = true;
+        } else if (arg == "--lexicographic") {
+            solverOptions.lexicographic = true;
+        } else if (arg == "--lexicographic-tolerance" && i + 1 < argc) {
+            solverOptions.lexicographicTolerance = std::stod(argv[++i]);
+            if (!(solverOptions.lexicographicTolerance >= 0.0)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--integer") {
+            solverOptions.integerUnits = true;
+        } else if (arg == "--integer-gap" && i + 1 < argc) {
+            solverOptions.integerGap = std::stod(argv[++i]);
+            if (!(solverOptions.integerGap >= 0.0)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--integer-max-nodes" && i + 1 < argc) {
+            solverOptions.integerMaxNodes = std::stoul(argv[++i]);
+        } else if (arg == "--sensitivity-report" && i + 1 < argc) {
+            solverOptions.sensitivityReportFile = argv[++i];
+        } else if (arg == "--parametric" && i + 1 < argc) {
+            // TARGET:FROM:TO, the target itself may contain a colon (row:N)
+            std::string spec = argv[++i];
+            size_t toPos = spec.rfind(':');
+            size_t fromPos = toPos == std::string::npos ? std::string::npos : spec.rfind(':', toPos - 1);
+            if (fromPos == std::string::npos || fromPos == 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            solverOptions.parametric.target = spec.substr(0, fromPos);
+            solverOptions.parametric.from = std::stod(spec.substr(fromPos + 1, toPos - fromPos - 1));
+            solverOptions.parametric.to = std::stod(spec.substr(toPos + 1));
+        } else if (arg == "--parametric-output" && i + 1 < argc) {
+            solverOptions.parametric.outputFile = argv[++i];
+        } else if (arg == "--results" && i + 1 < argc) {
+            solverOptions.resultsFile = argv[++i];
+        } else if (arg == "--sensitivity-results" && i + 1 < argc) {
+            solverOptions.sensitivityResultsFile = argv[++i];
+        } else if (arg == "--results-format" && i + 1 < argc) {
+            if (!parseResultFormat(argv[++i], solverOptions.resultsFormat)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--background-writer") {
+            solverOptions.backgroundWriter = true;
+        } else if (arg == "--top" && i + 1 < argc) {
+            solverOptions.topK = std::stoul(argv[++i]);
+        } else if (arg == "--cache" && i + 1 < argc) {
+            solverOptions.cacheDir = argv[++i];
+        } else if (arg == "--cache-max-mb" && i + 1 < argc) {
+            solverOptions.cacheMaxBytes = std::stoull(argv[++i]) << 20;
+        } else if (arg == "--site-max-iterations" && i + 1 < argc) {
+            decompositionOptions.maxIterations = std::stoul(argv[++i]);
+        } else if (arg == "--monte-carlo" && i + 1 < argc) {
+            solverOptions.monteCarlo.samples = std::stoul(argv[++i]);
+        } else if (arg == "--monte-carlo-seed" && i + 1 < argc) {
+            solverOptions.monteCarlo.seed = std::stoull(argv[++i]);
+        } else if (arg == "--monte-carlo-resolve" && i + 1 < argc) {
+            solverOptions.monteCarlo.resolveSamples = std::stoul(argv[++i]);
+        } else if (arg == "--monte-carlo-output" && i + 1 < argc) {
+            solverOptions.monteCarlo.outputFile = argv[++i];
+        } else if (arg[0] != '-' && !inputGiven) {
+            inputFile = arg;
+            inputGiven = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!metricsFile.empty()) {
+        enableMetrics();
+    }
+
+    ProductTable products;
     GlobalConstraints globalConstraints;
     std::vector<Objective> objectives;
+    SiteConfig sites;
+    HorizonConfig horizon;
 
     try {
-        // Parse inputs
-        products = parseInputConfig(inputFile, globalConstraints, objectives);
+        // Parse inputs, compiled models are mapped and used without parsing
+        if (isCompiledModel(inputFile)) {
+            products = loadCompiledModel(inputFile, globalConstraints, objectives);
+        } else {
+            products = parseInputConfig(inputFile, globalConstraints, objectives, solverOptions.sensitivity, sites, horizon);
+        }
         
         // Validate inputs
-        if (!validateInput(products, globalConstraints, objectives)) {
-            return 1;
+        if (!validateInput(products, globalConstraints)) {
+            return finishWithMetrics(1, metricsFile, metricsFormat);
         }
 
-        // Display parsed and validated inputs
+        // Display parsed and validated inputs, large catalogs only their first --top products
         std::cout << "Parsed Inputs:\n";
-        for (const auto& [name, product] : products) {
-            std::cout << "Product: " << name << "\n"
+        size_t shownProducts = solverOptions.topK != 0 ? std::min(products.size(), solverOptions.topK) : products.size();
+        for (size_t i = 0; i < shownProducts; ++i) {
+            Product product = products.get(i);
+            std::cout << "Product: " << product.name << "\n"
                       << "  Cost Range: [" << product.costMin << ", " << product.costMax << "]\n"
                       << "  Profit Range: [" << product.profitMin << ", " << product.profitMax << "]\n"
                       << "  Demand Range: [" << product.demandMin << ", " << product.demandMax << "]\n"
@@ -29,6 +369,9 @@ int main() {
                       << "  Man-Hour Per Unit Range: [" << product.manHourPerUnitMin << ", " << product.manHourPerUnitMax << "]\n"
                       << "  Total Man-Hours Range: [" << product.totalManHoursMin << ", " << product.totalManHoursMax << "]\n";
         }
+        if (shownProducts < products.size()) {
+            std::cout << "  ... and " << products.size() - shownProducts << " more\n";
+        }
 
         std::cout << "\nGlobal Constraints:\n"
                   << "  Global Budget Range: [" << globalConstraints.budgetMin << ", " << globalConstraints.budgetMax << "]\n"
@@ -41,15 +384,49 @@ int main() {
                       << " = " << objective.rank << "\n";
         }
 
+        // Plants sharing the global rows are solved by decomposition, one site per thread
+        if (!sites.empty()) {
+            std::string flag = unsupportedFlag(flags, {"--threads", "--algorithm", "--site-max-iterations",
+                                                       "--metrics", "--metrics-format"});
+            if (!flag.empty()) {
+                throw std::invalid_argument(flag + " is not supported for multi-site configs");
+            }
+            decompositionOptions.threads = solverOptions.threads;
+            decompositionOptions.algorithm = solverOptions.algorithm;
+            DecompositionResult decomposition =
+                solveSites(products, globalConstraints, objectives, sites, decompositionOptions);
+            displayDecomposition(decomposition);
+            return finishWithMetrics(decomposition.status == 0 ? 0 : 1, metricsFile, metricsFormat);
+        }
+
+        // Multi-period configs are planned window by window
+        if (!horizon.empty()) {
+            std::string flag = unsupportedFlag(flags, {"--algorithm", "--presolve", "--results", "--results-format",
+                                                       "--background-writer", "--metrics", "--metrics-format"});
+            if (!flag.empty()) {
+                throw std::invalid_argument(flag + " is not supported for multi-period configs");
+            }
+            HorizonOptions horizonOptions;
+            horizonOptions.algorithm = solverOptions.algorithm;
+            horizonOptions.presolve = solverOptions.presolve;
+            HorizonResult plan = solveRollingHorizon(products, globalConstraints, objectives, horizon, horizonOptions);
+            displayHorizon(plan);
+            if (!solverOptions.resultsFile.empty()) {
+                writeHorizonResults(plan, products, solverOptions.resultsFile, solverOptions.resultsFormat,
+                                    solverOptions.backgroundWriter);
+            }
+            return finishWithMetrics(plan.status == 0 ? 0 : 1, metricsFile, metricsFormat);
+        }
+
         // Initialize and run the solver
-        Solver solver(products, globalConstraints, objectives);
+        Solver solver(products, globalConstraints, objectives, solverOptions);
         solver.solve();
 
     } catch (const std::exception& ex) {
         std::cerr << "Error: " << ex.what() << "\n";
-        return 1;
+        return finishWithMetrics(1, metricsFile, metricsFormat);
     }
 
-    return 0;
+    return finishWithMetrics(0, metricsFile, metricsFormat);
 }
 
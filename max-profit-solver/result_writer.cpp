@@ -0,0 +1,307 @@
+#include "result_writer.h"
+#include "json_util.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+const size_t kBlockSize = 1 << 20;   // Bytes formatted before a block is handed off
+const size_t kQueuedBlocks = 4;      // Blocks the formatter may run ahead of the writer
+
+// Owns the output file and writes whole blocks, inline or on its own thread
+class BlockWriter {
+public:
+    BlockWriter(const std::string& filename, bool background) : filename(filename) {
+        file = filename == "-" ? stdout : std::fopen(filename.c_str(), "wb");
+        if (!file) {
+            throw std::runtime_error("Failed to open results file: " + filename);
+        }
+        if (background) {
+            writer = std::thread([this] { drain(); });
+        }
+    }
+
+    ~BlockWriter() {
+        if (writer.joinable()) {
+            finishThread();
+        }
+        if (file && file != stdout) {
+            std::fclose(file);
+        }
+    }
+
+    void write(std::string&& block) {
+        if (!writer.joinable()) {
+            writeBlock(block);
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        spaceFree.wait(lock, [this] { return queue.size() < kQueuedBlocks || failed; });
+        if (failed) {
+            throw std::runtime_error("Failed to write results file: " + filename);
+        }
+        queue.push_back(std::move(block));
+        blockReady.notify_one();
+    }
+
+    void close() {
+        if (writer.joinable()) {
+            finishThread();
+        }
+        bool ok = !failed && std::fflush(file) == 0;
+        if (file != stdout) {
+            ok = std::fclose(file) == 0 && ok;
+        }
+        file = nullptr;
+        if (!ok) {
+            throw std::runtime_error("Failed to write results file: " + filename);
+        }
+    }
+
+private:
+    std::string filename;
+    std::FILE* file = nullptr;
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable blockReady;
+    std::condition_variable spaceFree;
+    std::deque<std::string> queue;
+    bool done = false;
+    bool failed = false;
+
+    void writeBlock(const std::string& block) {
+        if (std::fwrite(block.data(), 1, block.size(), file) != block.size()) {
+            failed = true;
+            throw std::runtime_error("Failed to write results file: " + filename);
+        }
+    }
+
+    void drain() {
+        while (true) {
+            std::string block;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                blockReady.wait(lock, [this] { return !queue.empty() || done; });
+                if (queue.empty()) return;
+                block = std::move(queue.front());
+                queue.pop_front();
+            }
+            spaceFree.notify_one();
+            bool ok = std::fwrite(block.data(), 1, block.size(), file) == block.size();
+            if (!ok) {
+                std::lock_guard<std::mutex> lock(mutex);
+                failed = true;
+                queue.clear();
+                spaceFree.notify_all();
+                return;
+            }
+        }
+    }
+
+    void finishThread() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        blockReady.notify_one();
+        writer.join();
+    }
+};
+
+// Append-only text block, flushed to the writer when it fills up
+class BlockBuffer {
+public:
+    explicit BlockBuffer(BlockWriter& writer) : writer(writer) {
+        block.reserve(kBlockSize + 4096);
+    }
+
+    void append(std::string_view text) {
+        block.append(text.data(), text.size());
+    }
+
+    void append(char c) {
+        block.push_back(c);
+    }
+
+    void appendRaw(const void* data, size_t size) {
+        block.append(static_cast<const char*>(data), size);
+        flushIfFull();
+    }
+
+    // Shortest text that reads back as the same double
+    void appendNumber(double value, const char* nonFinite) {
+        if (!std::isfinite(value)) {
+            block += nonFinite;
+            return;
+        }
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        block.append(digits, result.ptr);
+    }
+
+    void appendCsvField(std::string_view text) {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+            append(text);
+            return;
+        }
+        block.push_back('"');
+        for (char c : text) {
+            if (c == '"') block.push_back('"');
+            block.push_back(c);
+        }
+        block.push_back('"');
+    }
+
+    void appendJsonString(std::string_view text) {
+        static const char kHex[] = "0123456789abcdef";
+        block.push_back('"');
+        for (char c : text) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                block.push_back('\\');
+                block.push_back(c);
+            } else if (byte < 0x20) {
+                block += "\\u00";
+                block.push_back(kHex[byte >> 4]);
+                block.push_back(kHex[byte & 15]);
+            } else {
+                block.push_back(c);
+            }
+        }
+        block.push_back('"');
+    }
+
+    void flushIfFull() {
+        if (block.size() >= kBlockSize) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (block.empty()) return;
+        std::string full;
+        full.reserve(kBlockSize + 4096);
+        full.swap(block);
+        writer.write(std::move(full));
+    }
+
+private:
+    BlockWriter& writer;
+    std::string block;
+};
+
+void writeCsv(const ResultTable& table, BlockBuffer& out) {
+    out.appendCsvField(table.labelName);
+    for (const auto& column : table.columns) {
+        out.append(',');
+        out.appendCsvField(column.first);
+    }
+    out.append('\n');
+    for (size_t row = 0; row < table.rows; ++row) {
+        out.appendCsvField(table.label(row));
+        for (const auto& column : table.columns) {
+            out.append(',');
+            out.appendNumber(column.second[row], "");
+        }
+        out.append('\n');
+        out.flushIfFull();
+    }
+}
+
+void writeNdjson(const ResultTable& table, BlockBuffer& out) {
+    // Keys are the same on every line, escape them once
+    std::vector<std::string> keys;
+    for (const auto& column : table.columns) {
+        keys.push_back(jsonString(column.first) + ":");
+    }
+    for (size_t row = 0; row < table.rows; ++row) {
+        out.append('{');
+        out.appendJsonString(table.labelName);
+        out.append(':');
+        out.appendJsonString(table.label(row));
+        for (size_t c = 0; c < table.columns.size(); ++c) {
+            out.append(',');
+            out.append(keys[c]);
+            out.appendNumber(table.columns[c].second[row], "null");
+        }
+        out.append("}\n");
+        out.flushIfFull();
+    }
+}
+
+template <typename T>
+void appendValue(BlockBuffer& out, T value) {
+    out.appendRaw(&value, sizeof(value));
+}
+
+void appendName(BlockBuffer& out, const std::string& name) {
+    appendValue(out, static_cast<uint32_t>(name.size()));
+    out.appendRaw(name.data(), name.size());
+}
+
+void writeBinary(const ResultTable& table, BlockBuffer& out) {
+    out.appendRaw("PMRT", 4);
+    appendValue(out, kResultFileVersion);
+    appendValue(out, static_cast<uint64_t>(table.rows));
+    appendValue(out, static_cast<uint32_t>(table.columns.size()));
+    appendName(out, table.labelName);
+    for (const auto& column : table.columns) {
+        appendName(out, column.first);
+    }
+
+    uint64_t offset = 0;
+    for (size_t row = 0; row < table.rows; ++row) {
+        offset += table.label(row).size();
+        appendValue(out, offset);
+    }
+    for (size_t row = 0; row < table.rows; ++row) {
+        std::string_view label = table.label(row);
+        out.appendRaw(label.data(), label.size());
+    }
+
+    // Columns go out in block sized slices straight from the solver arrays
+    const size_t sliceRows = kBlockSize / sizeof(double);
+    for (const auto& column : table.columns) {
+        for (size_t row = 0; row < table.rows; row += sliceRows) {
+            size_t count = std::min(sliceRows, table.rows - row);
+            out.appendRaw(column.second + row, count * sizeof(double));
+        }
+    }
+}
+
+} // namespace
+
+bool parseResultFormat(const std::string& name, ResultFormat& format) {
+    if (name == "csv") {
+        format = ResultFormat::Csv;
+    } else if (name == "ndjson") {
+        format = ResultFormat::Ndjson;
+    } else if (name == "binary") {
+        format = ResultFormat::Binary;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void writeResultTable(const ResultTable& table,
+                      const std::string& filename,
+                      ResultFormat format,
+                      bool backgroundWriter) {
+    BlockWriter writer(filename, backgroundWriter);
+    BlockBuffer out(writer);
+    switch (format) {
+        case ResultFormat::Csv: writeCsv(table, out); break;
+        case ResultFormat::Ndjson: writeNdjson(table, out); break;
+        case ResultFormat::Binary: writeBinary(table, out); break;
+    }
+    out.flush();
+    writer.close();
+}
@@ -0,0 +1,42 @@
+// result_writer.h
+#ifndef RESULT_WRITER_H
+#define RESULT_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum class ResultFormat { Csv, Ndjson, Binary };
+
+// "csv", "ndjson" or "binary"; false for anything else
+bool parseResultFormat(const std::string& name, ResultFormat& format);
+
+// Rows with one text label and any number of numeric columns. Columns are
+// borrowed, each must hold at least rows values.
+struct ResultTable {
+    size_t rows = 0;
+    std::string labelName;
+    std::function<std::string_view(size_t)> label;
+    std::vector<std::pair<std::string, const double*>> columns;
+};
+
+// Binary columnar layout, all integers and doubles in host byte order:
+//   "PMRT" | uint32 version | uint64 rows | uint32 numeric columns
+//   per column, label first: uint32 name length | name bytes
+//   uint64 label end offsets[rows] | label bytes
+//   per numeric column: double values[rows]
+const uint32_t kResultFileVersion = 1;
+
+// Write the table to filename ("-" for stdout). Text is formatted with
+// std::to_chars into large blocks; with backgroundWriter the blocks are
+// written by a second thread while the next one is being formatted.
+void writeResultTable(const ResultTable& table,
+                      const std::string& filename,
+                      ResultFormat format,
+                      bool backgroundWriter = false);
+
+#endif // RESULT_WRITER_H
@@ -0,0 +1,429 @@
+#include "rolling_horizon.h"
+#include "metrics.h"
+#include "solver.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+// Model data of one period, the same at any window position. Columns are
+// the production, sales and closing inventory of every product; rows are
+// the product budget and man-hour rows of the single-period model, one
+// inventory balance row per product and the period's global budget and
+// man-hour rows. Budget and man-hours are spent on production, profit is
+// earned on sales.
+struct PeriodBlock {
+    std::vector<double> columnLower;
+    std::vector<double> columnUpper;
+    std::vector<double> objective;
+    std::vector<double> rowLower;
+    std::vector<double> rowUpper;
+    std::vector<double> cost;      // Per unit produced
+    std::vector<double> manHours;
+    std::vector<double> profit;    // Per unit sold
+};
+
+using BlockPtr = std::shared_ptr<const PeriodBlock>;
+
+// Walks the periods in order, applying each period's changes to a working
+// copy of the ranges, so any period costs one pass over the catalog
+class PeriodCursor {
+public:
+    PeriodCursor(const ProductTable& products, const GlobalConstraints& globalConstraints,
+                 const HorizonConfig& horizon, const ObjectiveWeights& weights)
+        : products(products), globals(globalConstraints), horizon(horizon), weights(weights) {}
+
+    BlockPtr next() {
+        ++period;
+        const auto& productChanges = horizon.productChanges;
+        for (; productChange < productChanges.size() && productChanges[productChange].period <= period; ++productChange) {
+            const ProductChange& change = productChanges[productChange];
+            Product product = products.get(change.product);
+            product.*kProductFields[change.field] = change.min;
+            product.*kProductFields[change.field + 1] = change.max;
+            products.set(change.product, product);
+        }
+        const auto& globalChanges = horizon.globalChanges;
+        for (; globalChange < globalChanges.size() && globalChanges[globalChange].period <= period; ++globalChange) {
+            const GlobalChange& change = globalChanges[globalChange];
+            globals.*change.minField = change.min;
+            globals.*change.maxField = change.max;
+        }
+        return makeBlock();
+    }
+
+private:
+    ProductTable products;
+    GlobalConstraints globals;
+    const HorizonConfig& horizon;
+    ObjectiveWeights weights;
+    uint32_t period = 0;
+    size_t productChange = 0;
+    size_t globalChange = 0;
+
+    BlockPtr makeBlock() const {
+        size_t n = products.size();
+        auto block = std::make_shared<PeriodBlock>();
+        block->columnLower.assign(3 * n, 0.0);
+        block->columnUpper.assign(3 * n, std::numeric_limits<double>::max());
+        block->objective.resize(3 * n);
+        block->rowLower.assign(3 * n + 2, 0.0);
+        block->rowUpper.assign(3 * n + 2, 0.0);
+        block->cost.resize(n);
+        block->manHours.resize(n);
+        block->profit.resize(n);
+
+        const auto& costMin = products.column(&Product::costMin);
+        const auto& costMax = products.column(&Product::costMax);
+        const auto& profitMin = products.column(&Product::profitMin);
+        const auto& profitMax = products.column(&Product::profitMax);
+        const auto& demandMin = products.column(&Product::demandMin);
+        const auto& demandMax = products.column(&Product::demandMax);
+        const auto& budgetMin = products.column(&Product::budgetMin);
+        const auto& budgetMax = products.column(&Product::budgetMax);
+        const auto& manHourPerUnitMin = products.column(&Product::manHourPerUnitMin);
+        const auto& manHourPerUnitMax = products.column(&Product::manHourPerUnitMax);
+        const auto& totalManHoursMax = products.column(&Product::totalManHoursMax);
+
+        // Same averages and blended weights as the single-period model
+        for (size_t i = 0; i < n; ++i) {
+            double cost = (costMin[i] + costMax[i]) / 2.0;
+            double manHours = (manHourPerUnitMin[i] + manHourPerUnitMax[i]) / 2.0;
+            double profit = cost * (profitMin[i] + profitMax[i]) / 200.0;
+            block->cost[i] = cost;
+            block->manHours[i] = manHours;
+            block->profit[i] = profit;
+
+            block->objective[i] = weights.budget * cost - weights.resource * manHours;
+            block->columnLower[n + i] = demandMin[i];
+            block->columnUpper[n + i] = demandMax[i];
+            block->objective[n + i] = weights.profit * profit;
+            block->columnLower[2 * n + i] = horizon.inventoryMin[i];
+            block->columnUpper[2 * n + i] = horizon.inventoryMax[i];
+            block->objective[2 * n + i] = -weights.profit * horizon.holdingCost[i];
+
+            block->rowLower[2 * i] = budgetMin[i];
+            block->rowUpper[2 * i] = budgetMax[i];
+            block->rowUpper[2 * i + 1] = totalManHoursMax[i];
+        }
+        block->rowLower[3 * n] = globals.budgetMin;
+        block->rowUpper[3 * n] = globals.budgetMax;
+        block->rowUpper[3 * n + 1] = globals.manHoursMax;
+        return block;
+    }
+};
+
+// The Clp model of a window and the blocks and opening stock it holds.
+// Period p of the window owns columns [p * 3n, (p + 1) * 3n) and rows
+// [p * (3n + 2), (p + 1) * (3n + 2)); the closing inventory of period p
+// also enters the balance row of period p + 1.
+struct Window {
+    size_t products = 0;
+    std::vector<BlockPtr> blocks;
+    std::vector<double> opening;  // Stock entering the first period
+    ClpSimplex model;
+
+    size_t columnsPerBlock() const { return 3 * products; }
+    size_t rowsPerBlock() const { return 3 * products + 2; }
+
+    // Balance rows of the first period carry the opening stock
+    std::pair<double, double> rowBounds(const PeriodBlock& block, const std::vector<double>& stock, size_t position,
+                                        size_t row) const {
+        if (position == 0 && row >= 2 * products && row < 3 * products) {
+            double value = -stock[row - 2 * products];
+            return {value, value};
+        }
+        return {block.rowLower[row], block.rowUpper[row]};
+    }
+};
+
+void loadWindow(Window& window) {
+    size_t n = window.products;
+    size_t periods = window.blocks.size();
+    size_t blockColumns = window.columnsPerBlock();
+    size_t blockRows = window.rowsPerBlock();
+    size_t numColumns = periods * blockColumns;
+    size_t numRows = periods * blockRows;
+
+    std::vector<CoinBigIndex> columnStarts;
+    std::vector<int> rowIndices;
+    std::vector<double> elements;
+    std::vector<double> columnLower, columnUpper, objective, rowLower(numRows), rowUpper(numRows);
+    columnStarts.reserve(numColumns + 1);
+    rowIndices.reserve(periods * n * 8);
+    elements.reserve(periods * n * 8);
+    auto entry = [&](size_t row, double value) {
+        rowIndices.push_back(static_cast<int>(row));
+        elements.push_back(value);
+    };
+
+    for (size_t p = 0; p < periods; ++p) {
+        const PeriodBlock& block = *window.blocks[p];
+        size_t offset = p * blockRows;
+        for (size_t i = 0; i < n; ++i) {
+            columnStarts.push_back(static_cast<CoinBigIndex>(elements.size()));
+            entry(offset + 2 * i, block.cost[i]);
+            entry(offset + 2 * i + 1, block.manHours[i]);
+            entry(offset + 2 * n + i, 1.0);
+            entry(offset + 3 * n, block.cost[i]);
+            entry(offset + 3 * n + 1, block.manHours[i]);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            columnStarts.push_back(static_cast<CoinBigIndex>(elements.size()));
+            entry(offset + 2 * n + i, -1.0);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            columnStarts.push_back(static_cast<CoinBigIndex>(elements.size()));
+            entry(offset + 2 * n + i, -1.0);
+            if (p + 1 < periods) {
+                entry(offset + blockRows + 2 * n + i, 1.0);
+            }
+        }
+        columnLower.insert(columnLower.end(), block.columnLower.begin(), block.columnLower.end());
+        columnUpper.insert(columnUpper.end(), block.columnUpper.begin(), block.columnUpper.end());
+        objective.insert(objective.end(), block.objective.begin(), block.objective.end());
+        for (size_t r = 0; r < blockRows; ++r) {
+            std::tie(rowLower[offset + r], rowUpper[offset + r]) = window.rowBounds(block, window.opening, p, r);
+        }
+    }
+    columnStarts.push_back(static_cast<CoinBigIndex>(elements.size()));
+
+    window.model.setLogLevel(0);
+    window.model.loadProblem(static_cast<int>(numColumns), static_cast<int>(numRows), columnStarts.data(),
+                             rowIndices.data(), elements.data(), columnLower.data(), columnUpper.data(),
+                             objective.data(), rowLower.data(), rowUpper.data());
+    window.model.setOptimizationDirection(1);
+}
+
+// Move the basis back by shift periods. The periods entering at the end
+// start from the status of the last period, whose data they usually share.
+void shiftBasis(Window& window, size_t shift) {
+    unsigned char* status = window.model.statusArray();
+    if (status == nullptr) return;
+    size_t periods = window.blocks.size();
+    size_t blockColumns = window.columnsPerBlock();
+    size_t blockRows = window.rowsPerBlock();
+    size_t numColumns = periods * blockColumns;
+    std::vector<unsigned char> previous(status, status + numColumns + periods * blockRows);
+    for (size_t p = 0; p < periods; ++p) {
+        size_t source = std::min(p + shift, periods - 1);
+        std::copy_n(previous.begin() + source * blockColumns, blockColumns, status + p * blockColumns);
+        std::copy_n(previous.begin() + numColumns + source * blockRows, blockRows,
+                    status + numColumns + p * blockRows);
+    }
+}
+
+// Kinds of in-place edits, as in Solver
+enum : unsigned { BoundEdit = 1, ObjectiveEdit = 2, MatrixEdit = 4 };
+
+// Bring the loaded model to the given blocks and opening stock, touching
+// only the bounds, costs and coefficients that differ at each position
+unsigned updateWindow(Window& window, std::vector<BlockPtr> blocks, std::vector<double> opening,
+                      HorizonResult& result) {
+    size_t n = window.products;
+    size_t blockColumns = window.columnsPerBlock();
+    size_t blockRows = window.rowsPerBlock();
+    ClpSimplex& model = window.model;
+    unsigned edits = 0;
+
+    for (size_t p = 0; p < blocks.size(); ++p) {
+        const PeriodBlock& to = *blocks[p];
+        const PeriodBlock& from = *window.blocks[p];
+        int firstColumn = static_cast<int>(p * blockColumns);
+        int firstRow = static_cast<int>(p * blockRows);
+        for (size_t c = 0; c < blockColumns; ++c) {
+            int column = firstColumn + static_cast<int>(c);
+            bool changed = false;
+            if (to.columnLower[c] != from.columnLower[c] || to.columnUpper[c] != from.columnUpper[c]) {
+                model.setColumnBounds(column, to.columnLower[c], to.columnUpper[c]);
+                edits |= BoundEdit;
+                changed = true;
+            }
+            if (to.objective[c] != from.objective[c]) {
+                model.setObjectiveCoefficient(column, to.objective[c]);
+                edits |= ObjectiveEdit;
+                changed = true;
+            }
+            result.updatedColumns += changed;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            int column = firstColumn + static_cast<int>(i);
+            if (to.cost[i] != from.cost[i]) {
+                model.modifyCoefficient(firstRow + static_cast<int>(2 * i), column, to.cost[i]);
+                model.modifyCoefficient(firstRow + static_cast<int>(3 * n), column, to.cost[i]);
+                result.updatedElements += 2;
+                edits |= MatrixEdit;
+            }
+            if (to.manHours[i] != from.manHours[i]) {
+                model.modifyCoefficient(firstRow + static_cast<int>(2 * i + 1), column, to.manHours[i]);
+                model.modifyCoefficient(firstRow + static_cast<int>(3 * n + 1), column, to.manHours[i]);
+                result.updatedElements += 2;
+                edits |= MatrixEdit;
+            }
+        }
+        for (size_t r = 0; r < blockRows; ++r) {
+            auto bounds = window.rowBounds(to, opening, p, r);
+            if (bounds != window.rowBounds(from, window.opening, p, r)) {
+                model.setRowBounds(firstRow + static_cast<int>(r), bounds.first, bounds.second);
+                ++result.updatedRows;
+                edits |= BoundEdit;
+            }
+        }
+    }
+    window.blocks = std::move(blocks);
+    window.opening = std::move(opening);
+    return edits;
+}
+
+// Record the first count periods of the solved window as final
+void fixPeriods(const Window& window, size_t firstPeriod, size_t count, const HorizonConfig& horizon,
+                HorizonResult& result) {
+    size_t n = window.products;
+    const double* solution = window.model.getColSolution();
+    for (size_t p = 0; p < count; ++p) {
+        const PeriodBlock& block = *window.blocks[p];
+        const double* columns = solution + p * window.columnsPerBlock();
+        PeriodPlan plan;
+        plan.period = firstPeriod + p + 1;
+        plan.window = result.windows - 1;
+        for (size_t c = 0; c < window.columnsPerBlock(); ++c) {
+            plan.objectiveValue += block.objective[c] * columns[c];
+        }
+        for (size_t i = 0; i < n; ++i) {
+            double produced = columns[i];
+            double sold = columns[n + i];
+            double stock = columns[2 * n + i];
+            plan.profit += block.profit[i] * sold;
+            plan.budgetUsed += block.cost[i] * produced;
+            plan.manHoursUsed += block.manHours[i] * produced;
+            plan.holdingCost += horizon.holdingCost[i] * stock;
+            plan.inventory += stock;
+        }
+        result.production.insert(result.production.end(), columns, columns + n);
+        result.sales.insert(result.sales.end(), columns + n, columns + 2 * n);
+        result.inventory.insert(result.inventory.end(), columns + 2 * n, columns + 3 * n);
+        result.objectiveValue += plan.objectiveValue;
+        result.totalProfit += plan.profit;
+        result.totalBudgetUsed += plan.budgetUsed;
+        result.totalManHoursUsed += plan.manHoursUsed;
+        result.totalHoldingCost += plan.holdingCost;
+        result.periods.push_back(plan);
+    }
+}
+
+} // namespace
+
+HorizonResult solveRollingHorizon(const ProductTable& products, const GlobalConstraints& globalConstraints,
+                                  const std::vector<Objective>& objectives, const HorizonConfig& horizon,
+                                  const HorizonOptions& options) {
+    if (horizon.empty() || products.empty()) {
+        throw std::invalid_argument("Rolling horizon needs products and a [Horizon] section");
+    }
+    PhaseTimer timer(MetricsPhase::Solve);
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    HorizonResult result;
+    size_t periods = horizon.periods;
+    size_t windowPeriods = std::min(horizon.window, periods);
+    size_t step = std::min(horizon.step, windowPeriods);
+
+    PeriodCursor cursor(products, globalConstraints, horizon, blendWeights(objectives));
+    Window window;
+    window.products = products.size();
+    for (size_t p = 0; p < windowPeriods; ++p) {
+        window.blocks.push_back(cursor.next());
+    }
+    window.opening = horizon.initialInventory;
+    loadWindow(window);
+
+    // Windows start every step periods; the last one ends with the horizon
+    // and fixes all of its periods
+    size_t first = 0;
+    WarmStart warmStart = WarmStart::None;
+    while (true) {
+        runLpAlgorithm(window.model, options.algorithm, warmStart, options.presolve);
+        ++result.windows;
+        result.iterations += window.model.numberIterations();
+        result.status = window.model.status();
+        recordSolveMetrics(result.status, window.model.numberIterations(), window.model.numberRows(),
+                           window.model.numberColumns());
+        if (result.windows == 1) {
+            result.firstWindowMillis = elapsed();
+        }
+        if (result.status != 0) break;
+
+        bool last = first + windowPeriods >= periods;
+        size_t next = last ? periods : std::min(first + step, periods - windowPeriods);
+        fixPeriods(window, first, next - first, horizon, result);
+        if (last) break;
+
+        size_t shift = next - first;
+        std::vector<BlockPtr> blocks(window.blocks.begin() + shift, window.blocks.end());
+        for (size_t p = 0; p < shift; ++p) {
+            blocks.push_back(cursor.next());
+        }
+        size_t n = products.size();
+        const double* closing = window.model.getColSolution() + (shift - 1) * window.columnsPerBlock() + 2 * n;
+        std::vector<double> opening(closing, closing + n);
+
+        shiftBasis(window, shift);
+        unsigned edits = updateWindow(window, std::move(blocks), std::move(opening), result);
+        // Only bounds moved: the shifted basis keeps its reduced costs, dual simplex repairs the rest
+        warmStart = (edits & ~BoundEdit) == 0 ? WarmStart::Bounds : WarmStart::Other;
+        first = next;
+    }
+    result.millis = elapsed();
+    return result;
+}
+
+void displayHorizon(const HorizonResult& result) {
+    std::cout << "\nRolling horizon: " << solveStatusName(result.status) << ", " << result.periods.size()
+              << " periods fixed by " << result.windows << " windows, " << result.iterations
+              << " simplex iterations in " << result.millis << " ms (first window " << result.firstWindowMillis
+              << " ms)\n";
+    std::cout << "Updated in place after the first window: " << result.updatedColumns << " columns, "
+              << result.updatedRows << " rows, " << result.updatedElements << " coefficients\n";
+    std::cout << "Objective: " << result.objectiveValue << "\n";
+    std::cout << std::setw(8) << "Period" << std::setw(8) << "Window" << std::setw(15) << "Profit Value"
+              << std::setw(15) << "Budget Used" << std::setw(15) << "Man Hours" << std::setw(15) << "Inventory"
+              << std::setw(15) << "Holding Cost" << "\n";
+    std::cout << std::string(91, '-') << "\n";
+    for (const PeriodPlan& plan : result.periods) {
+        std::cout << std::setw(8) << plan.period << std::setw(8) << plan.window << std::setw(15) << plan.profit
+                  << std::setw(15) << plan.budgetUsed << std::setw(15) << plan.manHoursUsed << std::setw(15)
+                  << plan.inventory << std::setw(15) << plan.holdingCost << "\n";
+    }
+    std::cout << std::string(91, '-') << "\n";
+    std::cout << std::setw(8) << "Total" << std::setw(8) << "-" << std::setw(15) << result.totalProfit
+              << std::setw(15) << result.totalBudgetUsed << std::setw(15) << result.totalManHoursUsed
+              << std::setw(15) << "-" << std::setw(15) << result.totalHoldingCost << "\n";
+}
+
+void writeHorizonResults(const HorizonResult& result, const ProductTable& products, const std::string& filename,
+                         ResultFormat format, bool backgroundWriter) {
+    size_t n = products.size();
+    std::vector<double> period(result.production.size());
+    for (size_t row = 0; row < period.size(); ++row) {
+        period[row] = static_cast<double>(result.periods[row / n].period);
+    }
+
+    ResultTable table;
+    table.rows = period.size();
+    table.labelName = "product";
+    table.label = [&](size_t row) -> std::string_view { return products.name(row % n); };
+    table.columns = {{"period", period.data()},
+                     {"production", result.production.data()},
+                     {"sales", result.sales.data()},
+                     {"inventory", result.inventory.data()}};
+    writeResultTable(table, filename, format, backgroundWriter);
+}
@@ -0,0 +1,69 @@
+// rolling_horizon.h
+#ifndef ROLLING_HORIZON_H
+#define ROLLING_HORIZON_H
+
+#include "input.h"
+#include "lp_algorithm.h"
+#include "result_writer.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct HorizonOptions {
+    LpAlgorithm algorithm = LpAlgorithm::Auto;  // Clp algorithm, warm windows always use simplex
+    bool presolve = false;                      // Clp presolve on the first, cold window
+};
+
+// One period of the plan, fixed by the window that started with it
+struct PeriodPlan {
+    size_t period = 0;            // Counted from 1
+    size_t window = 0;            // Window that fixed the period, from 0
+    double objectiveValue = 0.0;  // Blended objective of the period's columns
+    double profit = 0.0;
+    double budgetUsed = 0.0;
+    double manHoursUsed = 0.0;
+    double holdingCost = 0.0;
+    double inventory = 0.0;       // Units in stock at the end of the period
+};
+
+struct HorizonResult {
+    int status = -1;              // Clp status of the last window solved, 0 when every window is optimal
+    size_t windows = 0;
+    int iterations = 0;           // Simplex iterations over all windows
+    double firstWindowMillis = 0.0;  // Build and cold solve of the first window
+    double millis = 0.0;
+    size_t updatedColumns = 0;    // Columns, rows and coefficients changed in place after the first window
+    size_t updatedRows = 0;
+    size_t updatedElements = 0;
+    double objectiveValue = 0.0;
+    double totalProfit = 0.0;
+    double totalBudgetUsed = 0.0;
+    double totalManHoursUsed = 0.0;
+    double totalHoldingCost = 0.0;
+    std::vector<PeriodPlan> periods;
+    // Units per fixed period and product, period-major
+    std::vector<double> production;
+    std::vector<double> sales;
+    std::vector<double> inventory;
+};
+
+// Plan the periods of a [Horizon] config by rolling horizon: each window of
+// consecutive periods is one LP with production, sales and end-of-period
+// inventory columns per product and period, linked by inventory balance
+// rows. The first step periods of a window are fixed and the window moves
+// on with their closing inventory as its opening stock. The Clp model is
+// kept: the basis is shifted along with the window, and only the bounds,
+// costs and coefficients that differ at each window position are updated
+// before a warm re-solve.
+HorizonResult solveRollingHorizon(const ProductTable& products, const GlobalConstraints& globalConstraints,
+                                  const std::vector<Objective>& objectives, const HorizonConfig& horizon,
+                                  const HorizonOptions& options);
+
+// Print the window statistics and one row per period
+void displayHorizon(const HorizonResult& result);
+
+// One row per fixed period and product: period, production, sales, inventory
+void writeHorizonResults(const HorizonResult& result, const ProductTable& products, const std::string& filename,
+                         ResultFormat format, bool backgroundWriter);
+
+#endif // ROLLING_HORIZON_H
@@ -0,0 +1,34 @@
+#include "sensitivity_report.h"
+#include "json_util.h"
+
+void writeSensitivityReport(const SensitivityReport& report, std::ostream& out) {
+    out << "{\"objective\":" << jsonNumber(report.objectiveValue)
+        << ",\"solve_millis\":" << jsonNumber(report.solveMillis)
+        << ",\"ranging_millis\":" << jsonNumber(report.rangingMillis)
+        << ",\"rows\":[";
+    for (size_t i = 0; i < report.rows.size(); ++i) {
+        const RowSensitivity& row = report.rows[i];
+        out << (i ? "," : "") << "\n{\"name\":" << jsonString(row.name)
+            << ",\"activity\":" << jsonNumber(row.activity)
+            << ",\"lower\":" << jsonNumber(row.lower)
+            << ",\"upper\":" << jsonNumber(row.upper)
+            << ",\"dual\":" << jsonNumber(row.dual)
+            << ",\"binding\":" << jsonString(row.binding)
+            << ",\"rhs_low\":" << jsonNumber(row.rhsLow)
+            << ",\"rhs_high\":" << jsonNumber(row.rhsHigh) << "}";
+    }
+    out << "],\"columns\":[";
+    for (size_t i = 0; i < report.columns.size(); ++i) {
+        const ColumnSensitivity& column = report.columns[i];
+        out << (i ? "," : "") << "\n{\"name\":" << jsonString(column.name)
+            << ",\"value\":" << jsonNumber(column.value)
+            << ",\"lower\":" << jsonNumber(column.lower)
+            << ",\"upper\":" << jsonNumber(column.upper)
+            << ",\"reduced_cost\":" << jsonNumber(column.reducedCost)
+            << ",\"basic\":" << (column.basic ? "true" : "false")
+            << ",\"cost\":" << jsonNumber(column.cost)
+            << ",\"cost_low\":" << jsonNumber(column.costLow)
+            << ",\"cost_high\":" << jsonNumber(column.costHigh) << "}";
+    }
+    out << "]}\n";
+}
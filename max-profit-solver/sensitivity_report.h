@@ -0,0 +1,40 @@
+// sensitivity_report.h
+#ifndef SENSITIVITY_REPORT_H
+#define SENSITIVITY_REPORT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Dual price and right-hand-side ranging of one row
+struct RowSensitivity {
+    std::string name;
+    double activity, lower, upper;
+    double dual;              // Objective change per unit of the binding bound
+    std::string binding;      // "lower", "upper" or "none"
+    double rhsLow, rhsHigh;   // Binding bound range with the same dual, infinite if not binding
+};
+
+// Reduced cost and objective-coefficient ranging of one column
+struct ColumnSensitivity {
+    std::string name;
+    double value, lower, upper;
+    double reducedCost;
+    bool basic;
+    double cost;              // Objective coefficient
+    double costLow, costHigh; // Coefficient range that keeps the basis optimal
+};
+
+// Sensitivity of the optimal solution, read off the final basis
+struct SensitivityReport {
+    double objectiveValue = 0.0;
+    double solveMillis = 0.0;
+    double rangingMillis = 0.0;
+    std::vector<RowSensitivity> rows;
+    std::vector<ColumnSensitivity> columns;
+};
+
+// Write the report as a single JSON document
+void writeSensitivityReport(const SensitivityReport& report, std::ostream& out);
+
+#endif // SENSITIVITY_REPORT_H
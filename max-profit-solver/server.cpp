@@ -0,0 +1,325 @@
+#include "server.h"
+#include "json_util.h"
+#include "model_file.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+struct RangeField {
+    const char* key;
+    double Product::* min;
+    double Product::* max;
+};
+
+const RangeField kProductRanges[] = {
+    {"cost_range", &Product::costMin, &Product::costMax},
+    {"profit_range", &Product::profitMin, &Product::profitMax},
+    {"demand_range", &Product::demandMin, &Product::demandMax},
+    {"budget_range", &Product::budgetMin, &Product::budgetMax},
+    {"man_hour_per_unit", &Product::manHourPerUnitMin, &Product::manHourPerUnitMax},
+    {"total_man_hours", &Product::totalManHoursMin, &Product::totalManHoursMax},
+};
+
+// Whitespace separated words; a word starting with a quote runs to the
+// closing quote so quoted product names may contain spaces
+std::vector<std::string> tokenize(const std::string& line) {
+    std::vector<std::string> tokens;
+    size_t pos = 0;
+    while (pos < line.size()) {
+        pos = line.find_first_not_of(" \t\r", pos);
+        if (pos == std::string::npos) break;
+        size_t end = line[pos] == '"' ? line.find('"', pos + 1) : line.find_first_of(" \t\r", pos);
+        if (end != std::string::npos && line[pos] == '"') ++end;
+        if (end == std::string::npos) end = line.size();
+        tokens.push_back(line.substr(pos, end - pos));
+        pos = end;
+    }
+    return tokens;
+}
+
+double parseNumber(const std::string& text) {
+    double value = 0.0;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || ptr != text.data() + text.size()) {
+        throw std::invalid_argument("Invalid number: " + text);
+    }
+    return value;
+}
+
+std::pair<double, double> parseBounds(const std::string& min, const std::string& max) {
+    double low = parseNumber(min);
+    double high = parseNumber(max);
+    if (low > high) {
+        throw std::invalid_argument("Range minimum " + min + " exceeds maximum " + max);
+    }
+    return {low, high};
+}
+
+std::string errorReply(const std::string& message) {
+    return "{\"ok\":false,\"error\":" + jsonString(message) + "}";
+}
+
+bool writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t count = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (count <= 0) return false;
+        written += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+// Answer line requests on one connected client until it quits or hangs up
+void serveConnection(SolverSession& session, int fd) {
+    std::string buffer;
+    char chunk[4096];
+    while (!session.finished()) {
+        size_t newline = buffer.find('\n');
+        if (newline == std::string::npos) {
+            ssize_t count = read(fd, chunk, sizeof(chunk));
+            if (count <= 0) break;
+            buffer.append(chunk, static_cast<size_t>(count));
+            continue;
+        }
+        std::string reply = session.handle(buffer.substr(0, newline));
+        buffer.erase(0, newline + 1);
+        if (!reply.empty() && !writeAll(fd, reply + "\n")) break;
+    }
+}
+
+int serveSocket(SolverSession& session, const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path too long: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+
+    // Replace a stale socket left by a previous run, never a regular file
+    if (std::filesystem::is_socket(path)) {
+        unlink(path.c_str());
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::runtime_error("Failed to create socket");
+    }
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 8) != 0) {
+        close(listener);
+        throw std::runtime_error("Failed to listen on socket: " + path);
+    }
+    std::cerr << "Listening on " << path << "\n";
+
+    // Clients are served one at a time, edits must apply in order anyway
+    while (true) {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) continue;
+        session.reset();
+        serveConnection(session, client);
+        close(client);
+    }
+}
+
+} // namespace
+
+SolverSession::SolverSession(const std::string& inputFile) {
+    if (isCompiledModel(inputFile)) {
+        products = loadCompiledModel(inputFile, globalConstraints, objectives);
+    } else {
+        products = parseInputConfig(inputFile, globalConstraints, objectives);
+    }
+
+    // Warnings are accepted without prompting like in batch mode
+    ValidationReport report = collectValidationIssues(products, globalConstraints);
+    if (!report.criticalErrors.empty()) {
+        throw std::runtime_error(report.criticalErrors.front());
+    }
+
+    SolverOptions options;
+    options.verbose = false;
+    solver = std::make_unique<Solver>(products, globalConstraints, objectives, options);
+    result = solver->solve();
+}
+
+size_t SolverSession::findColumn(const std::string& name) const {
+    // Config names keep their quotes, accept the bare name too
+    size_t index = products.find(name);
+    if (index == ProductTable::npos) {
+        index = products.find("\"" + name + "\"");
+    }
+    if (index == ProductTable::npos) {
+        throw std::invalid_argument("Unknown product: " + name);
+    }
+    return index;
+}
+
+std::string SolverSession::handle(const std::string& line) {
+    std::vector<std::string> args = tokenize(line);
+    if (args.empty() || args[0][0] == '#') {
+        return "";
+    }
+
+    try {
+        const std::string& command = args[0];
+        if (command == "set") return setProductRange(args);
+        if (command == "global") return setGlobalRange(args);
+        if (command == "objective") return setObjectiveRank(args);
+        if (command == "solve") {
+            auto start = std::chrono::steady_clock::now();
+            result = solver->resolve();
+            return resultReply(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+        if (command == "get" && args.size() == 2) {
+            size_t column = findColumn(args[1]);
+            return "{\"ok\":true,\"product\":" + jsonString(products.name(column)) +
+                   ",\"units\":" + (result.status == 0 ? jsonNumber(solver->columnValue(column)) : "null") + "}";
+        }
+        if (command == "stats") return statsReply();
+        if (command == "quit") {
+            quitRequested = true;
+            return "{\"ok\":true}";
+        }
+        return errorReply("Unknown request: " + line);
+    } catch (const std::exception& ex) {
+        return errorReply(ex.what());
+    }
+}
+
+std::string SolverSession::setProductRange(const std::vector<std::string>& args) {
+    if (args.size() != 5) {
+        throw std::invalid_argument("Usage: set <product> <range_key> <min> <max>");
+    }
+    size_t column = findColumn(args[1]);
+    auto field = std::find_if(std::begin(kProductRanges), std::end(kProductRanges),
+                              [&](const RangeField& range) { return args[2] == range.key; });
+    if (field == std::end(kProductRanges)) {
+        throw std::invalid_argument("Unknown product range: " + args[2]);
+    }
+    auto [low, high] = parseBounds(args[3], args[4]);
+
+    auto start = std::chrono::steady_clock::now();
+    Product product = products.get(column);
+    product.*field->min = low;
+    product.*field->max = high;
+    products.set(column, product);
+    solver->updateProduct(column);
+    result = solver->resolve();
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    latencies.push_back(micros);
+    return resultReply(micros);
+}
+
+std::string SolverSession::setGlobalRange(const std::vector<std::string>& args) {
+    if (args.size() != 4) {
+        throw std::invalid_argument("Usage: global <range_key> <min> <max>");
+    }
+    auto [low, high] = parseBounds(args[2], args[3]);
+
+    auto start = std::chrono::steady_clock::now();
+    if (args[1] == "global_budget") {
+        globalConstraints.budgetMin = low;
+        globalConstraints.budgetMax = high;
+    } else if (args[1] == "global_profit") {
+        globalConstraints.profitMin = low;
+        globalConstraints.profitMax = high;
+    } else if (args[1] == "global_man_hours") {
+        globalConstraints.manHoursMin = low;
+        globalConstraints.manHoursMax = high;
+    } else {
+        throw std::invalid_argument("Unknown global range: " + args[1]);
+    }
+    solver->updateGlobalConstraints();
+    result = solver->resolve();
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    latencies.push_back(micros);
+    return resultReply(micros);
+}
+
+std::string SolverSession::setObjectiveRank(const std::vector<std::string>& args) {
+    if (args.size() != 3) {
+        throw std::invalid_argument("Usage: objective <type>_<name> <rank>");
+    }
+    // Same key format and rank cap as the [Objectives] section
+    size_t split = args[1].find('_');
+    std::string type = args[1].substr(0, split);
+    if (split == std::string::npos || (type != "maximize" && type != "minimize")) {
+        throw std::invalid_argument("Invalid objective key: " + args[1]);
+    }
+    std::string name = args[1].substr(split + 1);
+    int rank = 0;
+    auto [ptr, ec] = std::from_chars(args[2].data(), args[2].data() + args[2].size(), rank);
+    if (ec != std::errc() || ptr != args[2].data() + args[2].size() || rank < 1) {
+        throw std::invalid_argument("Invalid objective rank: " + args[2]);
+    }
+    rank = std::min(rank, 10);
+
+    auto start = std::chrono::steady_clock::now();
+    auto it = std::find_if(objectives.begin(), objectives.end(),
+                           [&](const Objective& objective) { return objective.name == name && objective.type == type; });
+    if (it == objectives.end()) {
+        objectives.push_back({name, type, rank});
+    } else {
+        it->rank = rank;
+    }
+    solver->updateObjectives();
+    result = solver->resolve();
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    latencies.push_back(micros);
+    return resultReply(micros);
+}
+
+std::string SolverSession::resultReply(double micros) const {
+    // Values of a non-optimal solve are the last iterate, not a plan
+    bool optimal = result.status == 0;
+    auto value = [optimal](double number) { return optimal ? jsonNumber(number) : std::string("null"); };
+    return "{\"ok\":true,\"status\":" + jsonString(solveStatusName(result.status)) +
+           ",\"objective\":" + value(result.objectiveValue) +
+           ",\"profit\":" + value(result.totalProfit) +
+           ",\"budget_used\":" + value(result.totalBudgetUsed) +
+           ",\"man_hours_used\":" + value(result.totalManHoursUsed) +
+           ",\"iterations\":" + std::to_string(result.iterations) +
+           ",\"micros\":" + jsonNumber(micros) + "}";
+}
+
+std::string SolverSession::statsReply() const {
+    std::vector<double> sorted = latencies;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double fraction) {
+        return sorted.empty() ? 0.0 : sorted[static_cast<size_t>(fraction * (sorted.size() - 1))];
+    };
+    return "{\"ok\":true,\"products\":" + std::to_string(products.size()) +
+           ",\"edits\":" + std::to_string(sorted.size()) +
+           ",\"p50_micros\":" + jsonNumber(percentile(0.5)) +
+           ",\"p99_micros\":" + jsonNumber(percentile(0.99)) +
+           ",\"max_micros\":" + jsonNumber(sorted.empty() ? 0.0 : sorted.back()) + "}";
+}
+
+int runServer(const ServerOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    SolverSession session(options.inputFile);
+    std::cerr << "Loaded " << session.productCount() << " products from " << options.inputFile << " ("
+              << solveStatusName(session.lastResult().status) << ") in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+              << " ms\n";
+
+    if (!options.socketPath.empty()) {
+        return serveSocket(session, options.socketPath);
+    }
+
+    std::string line;
+    while (!session.finished() && std::getline(std::cin, line)) {
+        std::string reply = session.handle(line);
+        if (!reply.empty()) {
+            std::cout << reply << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+// server.h
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "input.h"
+#include "solver.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Resident solver run configuration
+struct ServerOptions {
+    std::string inputFile = "input.config";
+    std::string socketPath;  // Unix domain socket, empty = stdin/stdout line protocol
+};
+
+// One loaded model kept in memory between requests. Every request is a
+// single line and gets a single JSON line back:
+//   set <product> <range_key> <min> <max>   product range from input.config
+//   global <range_key> <min> <max>          global_budget, global_profit, global_man_hours
+//   objective <type>_<name> <rank>          e.g. objective maximize_profit 2
+//   solve | get <product> | stats | quit
+// Edits are applied to the loaded ClpSimplex in place and re-solved from
+// the current basis before the reply is sent. Objective, totals and units
+// are null while the last solve is not optimal.
+class SolverSession {
+public:
+    explicit SolverSession(const std::string& inputFile);
+
+    std::string handle(const std::string& line);
+    bool finished() const { return quitRequested; }
+    void reset() { quitRequested = false; }
+    size_t productCount() const { return products.size(); }
+    const SolveResult& lastResult() const { return result; }
+
+private:
+    ProductTable products;
+    GlobalConstraints globalConstraints{};
+    std::vector<Objective> objectives;
+    std::unique_ptr<Solver> solver;
+    SolveResult result;
+    std::vector<double> latencies;  // Microseconds per edit, for stats
+    bool quitRequested = false;
+
+    size_t findColumn(const std::string& name) const;
+    std::string setProductRange(const std::vector<std::string>& args);
+    std::string setGlobalRange(const std::vector<std::string>& args);
+    std::string setObjectiveRank(const std::vector<std::string>& args);
+    std::string resultReply(double micros) const;
+    std::string statsReply() const;
+};
+
+// Serve requests until quit (stdin) or until the process is stopped (socket)
+int runServer(const ServerOptions& options);
+
+#endif // SERVER_H
@@ -0,0 +1,352 @@
+#include "site_decomposition.h"
+#include "solver.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+// Artificial columns cost this many times the most any unit of a row can earn
+const double kArtificialPenalty = 1e4;
+const double kReducedCostTolerance = 1e-9;
+const double kArtificialTolerance = 1e-7;
+
+// One plan a site offered the master
+struct Proposal {
+    double objective = 0.0;
+    double budget = 0.0;
+    double manHours = 0.0;
+    std::vector<double> units;
+};
+
+// A plant assembled as its own single-plant model, with the plant limits
+// in place of the global rows. Its last two rows therefore carry exactly
+// the budget and man-hours every column adds to the shared rows.
+struct Site {
+    ProductTable products;
+    GlobalConstraints limits{};
+    std::vector<size_t> productIndex;  // Position of each site product in the full table
+    std::unique_ptr<Solver> solver;
+    LpView lp;
+    std::vector<double> budget;
+    std::vector<double> manHours;
+    std::vector<double> priced;        // Objective less the shared rows' prices
+    std::unique_ptr<ClpSimplex> clp;   // Built when the fast path does not apply
+    std::vector<Proposal> proposals;
+    Proposal last;
+    double lastValue = 0.0;            // Priced objective of the last plan
+    bool infeasible = false;
+    size_t fastPathSolves = 0;
+};
+
+void buildSite(Site& site, const std::vector<Objective>& objectives) {
+    SolverOptions options;
+    options.verbose = false;
+    site.solver = std::make_unique<Solver>(site.products, site.limits, objectives, options);
+    site.solver->assembleModel();
+    site.lp = site.solver->lpView();
+
+    int budgetRow = site.lp.numRows - 2;
+    int manHoursRow = site.lp.numRows - 1;
+    site.budget.assign(site.lp.numColumns, 0.0);
+    site.manHours.assign(site.lp.numColumns, 0.0);
+    site.priced.resize(site.lp.numColumns);
+    for (int column = 0; column < site.lp.numColumns; ++column) {
+        for (CoinBigIndex k = site.lp.columnStarts[column]; k < site.lp.columnStarts[column + 1]; ++k) {
+            if (site.lp.rowIndices[k] == budgetRow) site.budget[column] = site.lp.elements[k];
+            if (site.lp.rowIndices[k] == manHoursRow) site.manHours[column] = site.lp.elements[k];
+        }
+    }
+}
+
+// Best plan of the site at the given prices on the shared rows. The fast
+// path takes it whenever the site model has its usual shape; otherwise the
+// site keeps one Clp model and re-solves it from its last basis.
+void priceSite(Site& site, double budgetPrice, double manHoursPrice, LpAlgorithm algorithm) {
+    for (int column = 0; column < site.lp.numColumns; ++column) {
+        site.priced[column] = site.lp.objective[column] - budgetPrice * site.budget[column] -
+                              manHoursPrice * site.manHours[column];
+    }
+
+    LpView priced = site.lp;
+    priced.objective = site.priced.data();
+    StructuredSolution structured = solveStructured(priced);
+    const double* units = nullptr;
+    if (structured.outcome == StructuredSolution::Optimal) {
+        ++site.fastPathSolves;
+        units = structured.columnValues.data();
+    } else if (structured.outcome == StructuredSolution::Infeasible) {
+        site.infeasible = true;
+        return;
+    } else {
+        WarmStart warmStart = WarmStart::Other;
+        if (!site.clp) {
+            site.clp = std::make_unique<ClpSimplex>();
+            site.clp->setLogLevel(0);
+            site.clp->loadProblem(site.lp.numColumns, site.lp.numRows, site.lp.columnStarts, site.lp.rowIndices,
+                                  site.lp.elements, site.lp.columnLower, site.lp.columnUpper, site.priced.data(),
+                                  site.lp.rowLower, site.lp.rowUpper);
+            warmStart = WarmStart::None;
+        } else {
+            site.clp->chgObjCoefficients(site.priced.data());
+        }
+        runLpAlgorithm(*site.clp, algorithm, warmStart, false);
+        if (site.clp->status() != 0) {
+            site.infeasible = true;
+            return;
+        }
+        units = site.clp->getColSolution();
+    }
+
+    Proposal& plan = site.last;
+    plan = Proposal();
+    plan.units.assign(units, units + site.lp.numColumns);
+    site.lastValue = 0.0;
+    for (int column = 0; column < site.lp.numColumns; ++column) {
+        plan.objective += site.lp.objective[column] * units[column];
+        plan.budget += site.budget[column] * units[column];
+        plan.manHours += site.manHours[column] * units[column];
+        site.lastValue += site.priced[column] * units[column];
+    }
+}
+
+// Most any unit of the row can change the objective by, over every site
+double rowPenalty(const std::vector<std::unique_ptr<Site>>& sites, std::vector<double> Site::* coefficients) {
+    double worst = 0.0;
+    for (const auto& site : sites) {
+        const std::vector<double>& entries = (*site).*coefficients;
+        for (int column = 0; column < site->lp.numColumns; ++column) {
+            if (entries[column] > 0.0) {
+                worst = std::max(worst, std::abs(site->lp.objective[column]) / entries[column]);
+            }
+        }
+    }
+    return kArtificialPenalty * (1.0 + worst);
+}
+
+double sitePenalty(const Site& site) {
+    double total = 0.0;
+    for (int column = 0; column < site.lp.numColumns; ++column) {
+        double extent = std::max(std::abs(site.lp.columnLower[column]), std::abs(site.lp.columnUpper[column]));
+        total += std::abs(site.lp.objective[column]) * extent;
+    }
+    return kArtificialPenalty * (1.0 + total);
+}
+
+} // namespace
+
+DecompositionResult solveSites(const ProductTable& products, const GlobalConstraints& globalConstraints,
+                               const std::vector<Objective>& objectives, const SiteConfig& siteConfig,
+                               const DecompositionOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    DecompositionResult result;
+    size_t numSites = siteConfig.sites.size();
+
+    std::vector<std::unique_ptr<Site>> sites;
+    for (const SiteLimits& limits : siteConfig.sites) {
+        auto site = std::make_unique<Site>();
+        site->limits.budgetMin = limits.budgetMin;
+        site->limits.budgetMax = limits.budgetMax;
+        site->limits.manHoursMax = limits.manHoursMax;
+        sites.push_back(std::move(site));
+    }
+    for (size_t i = 0; i < products.size(); ++i) {
+        Site& site = *sites[siteConfig.productSite[i]];
+        site.productIndex.push_back(i);
+        site.products.insertOrAssign(products.get(i));
+    }
+
+    // Sites are independent from here on, one task each
+    std::unique_ptr<ThreadPool> pool;
+    if (options.threads != 1 && numSites > 1 && ThreadPool::currentWorker() < 0) {
+        pool = std::make_unique<ThreadPool>(options.threads);
+    }
+    auto forEachSite = [&](const std::function<void(Site&)>& body) {
+        if (pool) {
+            pool->parallelFor(numSites, [&](size_t s) { body(*sites[s]); });
+        } else {
+            for (auto& site : sites) body(*site);
+        }
+    };
+    forEachSite([&](Site& site) { buildSite(site, objectives); });
+
+    // Master rows: the shared budget and man-hours, then one convexity row per site
+    int numRows = static_cast<int>(2 + numSites);
+    std::vector<double> rowLower(numRows, 1.0), rowUpper(numRows, 1.0);
+    rowLower[0] = globalConstraints.budgetMin;
+    rowUpper[0] = globalConstraints.budgetMax;
+    rowLower[1] = 0.0;
+    rowUpper[1] = globalConstraints.manHoursMax;
+    std::vector<CoinBigIndex> noStarts(1, 0);
+    ClpSimplex master;
+    master.setLogLevel(0);
+    master.loadProblem(0, numRows, noStarts.data(), nullptr, nullptr, nullptr, nullptr, nullptr,
+                       rowLower.data(), rowUpper.data());
+
+    // Master columns, appended a batch at a time
+    struct Column { int site; size_t proposal; };  // site -1 for artificials
+    std::vector<Column> columns;
+    std::vector<double> batchLower, batchUpper, batchObjective, batchElements;
+    std::vector<CoinBigIndex> batchStarts(1, 0);
+    std::vector<int> batchRows;
+    auto addColumn = [&](Column column, double objective, std::initializer_list<std::pair<int, double>> entries) {
+        columns.push_back(column);
+        batchLower.push_back(0.0);
+        batchUpper.push_back(std::numeric_limits<double>::max());
+        batchObjective.push_back(objective);
+        for (const auto& entry : entries) {
+            batchRows.push_back(entry.first);
+            batchElements.push_back(entry.second);
+        }
+        batchStarts.push_back(static_cast<CoinBigIndex>(batchRows.size()));
+    };
+    auto flushColumns = [&]() {
+        int count = static_cast<int>(batchStarts.size() - 1);
+        if (count == 0) return;
+        master.addColumns(count, batchLower.data(), batchUpper.data(), batchObjective.data(), batchStarts.data(),
+                          batchRows.data(), batchElements.data());
+        batchLower.clear();
+        batchUpper.clear();
+        batchObjective.clear();
+        batchElements.clear();
+        batchRows.clear();
+        batchStarts.assign(1, 0);
+    };
+
+    double budgetPenalty = rowPenalty(sites, &Site::budget);
+    double manHoursPenalty = rowPenalty(sites, &Site::manHours);
+    addColumn({-1, 0}, budgetPenalty, {{0, 1.0}});
+    addColumn({-1, 0}, budgetPenalty, {{0, -1.0}});
+    addColumn({-1, 0}, manHoursPenalty, {{1, -1.0}});
+    for (size_t s = 0; s < numSites; ++s) {
+        addColumn({-1, 0}, sitePenalty(*sites[s]), {{static_cast<int>(2 + s), 1.0}});
+    }
+
+    std::vector<double> convexityPrice(numSites, 0.0);
+    bool converged = false;
+    for (size_t iteration = 0; iteration < options.maxIterations; ++iteration) {
+        forEachSite([&](Site& site) { priceSite(site, result.budgetPrice, result.manHoursPrice, options.algorithm); });
+        for (const auto& site : sites) {
+            if (site->infeasible) {
+                result.status = 1;
+                result.iterations = iteration;
+                result.millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                return result;
+            }
+        }
+
+        // A site plan with negative reduced cost would improve the master
+        double bound = master.objectiveValue();
+        bool added = false;
+        for (size_t s = 0; s < numSites; ++s) {
+            Site& site = *sites[s];
+            double reducedCost = site.lastValue - convexityPrice[s];
+            bound += std::min(0.0, reducedCost);
+            if (iteration > 0 && reducedCost >= -kReducedCostTolerance * (1.0 + std::abs(site.lastValue))) continue;
+            addColumn({static_cast<int>(s), site.proposals.size()}, site.last.objective,
+                      {{0, site.last.budget}, {1, site.last.manHours}, {static_cast<int>(2 + s), 1.0}});
+            site.proposals.push_back(std::move(site.last));
+            added = true;
+        }
+        if (iteration > 0) {
+            result.lowerBound = std::max(result.lowerBound, bound);
+            double objective = master.objectiveValue();
+            if (!added || objective - result.lowerBound <= options.relativeGap * std::max(1.0, std::abs(objective))) {
+                converged = true;
+                break;
+            }
+        }
+
+        // New columns enter at zero, so the last basis stays primal feasible
+        flushColumns();
+        runLpAlgorithm(master, options.algorithm, iteration == 0 ? WarmStart::None : WarmStart::Other, false);
+        result.iterations = iteration + 1;
+        if (master.status() != 0) {
+            break;
+        }
+        const double* duals = master.dualRowSolution();
+        result.budgetPrice = duals[0];
+        result.manHoursPrice = duals[1];
+        for (size_t s = 0; s < numSites; ++s) {
+            convexityPrice[s] = duals[2 + s];
+        }
+    }
+
+    // Each site's plan is the convex combination of its proposals
+    const double* weights = master.getColSolution();
+    result.columnValues.assign(products.size(), 0.0);
+    result.objectiveValue = 0.0;
+    bool artificial = false;
+    for (size_t j = 0; j < columns.size() && j < static_cast<size_t>(master.numberColumns()); ++j) {
+        if (columns[j].site < 0) {
+            artificial = artificial || weights[j] > kArtificialTolerance;
+            continue;
+        }
+        if (weights[j] == 0.0) continue;
+        Site& site = *sites[columns[j].site];
+        const Proposal& plan = site.proposals[columns[j].proposal];
+        result.objectiveValue += weights[j] * plan.objective;
+        for (size_t k = 0; k < plan.units.size(); ++k) {
+            result.columnValues[site.productIndex[k]] += weights[j] * plan.units[k];
+        }
+    }
+    if (master.status() != 0 || artificial) {
+        result.status = 1;
+    } else {
+        result.status = converged ? 0 : 3;
+    }
+
+    const auto& costMin = products.column(&Product::costMin);
+    const auto& costMax = products.column(&Product::costMax);
+    const auto& profitMin = products.column(&Product::profitMin);
+    const auto& profitMax = products.column(&Product::profitMax);
+    for (size_t s = 0; s < numSites; ++s) {
+        Site& site = *sites[s];
+        SiteSolution summary;
+        summary.name = siteConfig.sites[s].name;
+        summary.products = site.productIndex.size();
+        summary.proposals = site.proposals.size();
+        summary.fastPathSolves = site.fastPathSolves;
+        for (size_t k = 0; k < site.productIndex.size(); ++k) {
+            size_t i = site.productIndex[k];
+            double units = result.columnValues[i];
+            double avgCost = (costMin[i] + costMax[i]) / 2.0;
+            summary.objectiveValue += site.lp.objective[k] * units;
+            summary.profit += units * avgCost * (profitMin[i] + profitMax[i]) / 200.0;
+            summary.budgetUsed += site.budget[k] * units;
+            summary.manHoursUsed += site.manHours[k] * units;
+        }
+        result.totalProfit += summary.profit;
+        result.totalBudgetUsed += summary.budgetUsed;
+        result.totalManHoursUsed += summary.manHoursUsed;
+        result.sites.push_back(std::move(summary));
+    }
+    result.millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void displayDecomposition(const DecompositionResult& result) {
+    std::cout << "\nSite decomposition: " << solveStatusName(result.status) << " after " << result.iterations
+              << " pricing rounds in " << result.millis << " ms\n";
+    std::cout << "Objective: " << result.objectiveValue << ", Lagrangian bound: " << result.lowerBound
+              << ", Budget price: " << result.budgetPrice << ", Man-hour price: " << result.manHoursPrice << "\n";
+    std::cout << std::setw(20) << "Site" << std::setw(10) << "Products" << std::setw(15) << "Profit Value"
+              << std::setw(15) << "Budget Used" << std::setw(15) << "Man Hours" << std::setw(11) << "Proposals" << "\n";
+    std::cout << std::string(86, '-') << "\n";
+    for (const SiteSolution& site : result.sites) {
+        std::cout << std::setw(20) << site.name << std::setw(10) << site.products << std::setw(15) << site.profit
+                  << std::setw(15) << site.budgetUsed << std::setw(15) << site.manHoursUsed << std::setw(11)
+                  << site.proposals << "\n";
+    }
+    std::cout << std::string(86, '-') << "\n";
+    std::cout << std::setw(20) << "Total" << std::setw(10) << "-" << std::setw(15) << result.totalProfit
+              << std::setw(15) << result.totalBudgetUsed << std::setw(15) << result.totalManHoursUsed
+              << std::setw(11) << "-" << "\n";
+}
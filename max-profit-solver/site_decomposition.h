@@ -0,0 +1,59 @@
+// site_decomposition.h
+#ifndef SITE_DECOMPOSITION_H
+#define SITE_DECOMPOSITION_H
+
+#include "input.h"
+#include "lp_algorithm.h"
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+struct DecompositionOptions {
+    unsigned threads = 0;         // Worker threads for site subproblems, 0 = all cores
+    size_t maxIterations = 200;   // Pricing rounds before giving up on convergence
+    double relativeGap = 1e-6;    // Stop once the master is this close to the Lagrangian bound
+    LpAlgorithm algorithm = LpAlgorithm::Auto;  // Clp algorithm for the master and off-fast-path sites
+};
+
+struct SiteSolution {
+    std::string name;
+    size_t products = 0;
+    double objectiveValue = 0.0;  // Blended objective of the site's share of the plan
+    double profit = 0.0;
+    double budgetUsed = 0.0;
+    double manHoursUsed = 0.0;
+    size_t proposals = 0;         // Plans the site offered the master
+    size_t fastPathSolves = 0;    // Subproblems solved by the structured fast path
+};
+
+struct DecompositionResult {
+    int status = -1;              // Clp status codes: 0 optimal, 1 infeasible, 3 iteration limit
+    double objectiveValue = 0.0;
+    double lowerBound = -std::numeric_limits<double>::infinity();
+    size_t iterations = 0;
+    double budgetPrice = 0.0;     // Duals of the shared global_budget and global_man_hours rows
+    double manHoursPrice = 0.0;
+    double millis = 0.0;
+    std::vector<double> columnValues;  // Units of every product, product table order
+    std::vector<SiteSolution> sites;
+    double totalProfit = 0.0;
+    double totalBudgetUsed = 0.0;
+    double totalManHoursUsed = 0.0;
+};
+
+// Dantzig-Wolfe decomposition over the sites of a multi-site config. Each
+// site is an ordinary single-plant model whose coupling rows are its own
+// limits; the master only holds the shared global budget and man-hours
+// rows, one convexity row per site and penalized artificial columns that
+// keep it feasible until the sites have offered enough plans. Every round
+// the sites are re-priced with the master's duals and solved in parallel,
+// so time and memory per round grow linearly with the number of sites.
+DecompositionResult solveSites(const ProductTable& products, const GlobalConstraints& globalConstraints,
+                               const std::vector<Objective>& objectives, const SiteConfig& sites,
+                               const DecompositionOptions& options);
+
+// Print the convergence summary and one row per site
+void displayDecomposition(const DecompositionResult& result);
+
+#endif // SITE_DECOMPOSITION_H
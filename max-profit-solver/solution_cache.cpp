@@ -0,0 +1,315 @@
+#include "solution_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kMagic[4] = {'P', 'M', 'S', 'C'};
+const uint32_t kVersion = 1;
+const char* const kExtension = ".pms";
+
+std::atomic<uint64_t> exactHits{0}, nearHits{0}, misses{0}, stores{0}, evictions{0};
+
+uint64_t mixA(uint64_t x) {
+    x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27; x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+uint64_t mixB(uint64_t x) {
+    x ^= x >> 33; x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33; x *= 0xC4CEB9FE1A85EC53ull;
+    return x ^ (x >> 33);
+}
+
+// Two independently mixed 64-bit lanes fed the same word stream
+class CanonicalHash {
+public:
+    void addWord(uint64_t word) {
+        a = mixA(a ^ word);
+        b = mixB(b ^ (word * 0x9E3779B97F4A7C15ull + 0x632BE59BD9B4E019ull));
+    }
+
+    void addDouble(double value) {
+        if (value == 0.0) value = 0.0;  // -0.0 and 0.0 alike
+        if (std::isnan(value)) value = std::numeric_limits<double>::quiet_NaN();
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        addWord(bits);
+    }
+
+    void addString(const std::string& text) {
+        addWord(text.size());
+        for (size_t i = 0; i < text.size(); i += 8) {
+            uint64_t word = 0;
+            std::memcpy(&word, text.data() + i, std::min<size_t>(8, text.size() - i));
+            addWord(word);
+        }
+    }
+
+    std::string hex(bool bothLanes) const {
+        static const char kDigits[] = "0123456789abcdef";
+        std::string text;
+        for (uint64_t lane : {a, b}) {
+            for (int shift = 60; shift >= 0; shift -= 4) {
+                text.push_back(kDigits[(lane >> shift) & 15]);
+            }
+            if (!bothLanes) break;
+        }
+        return text;
+    }
+
+private:
+    uint64_t a = 0x6A09E667F3BCC908ull;
+    uint64_t b = 0xBB67AE8584CAA73Bull;
+};
+
+template <typename T>
+void appendValue(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+void appendArray(std::string& out, const std::vector<T>& values) {
+    out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+// Bounds-checked reads over a loaded entry
+class EntryReader {
+public:
+    explicit EntryReader(const std::string& data) : data(data) {}
+
+    template <typename T>
+    bool read(T& value) {
+        if (data.size() - pos < sizeof(T)) return false;
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& values, size_t count) {
+        if ((data.size() - pos) / sizeof(T) < count) return false;
+        values.resize(count);
+        std::memcpy(values.data(), data.data() + pos, count * sizeof(T));
+        pos += count * sizeof(T);
+        return true;
+    }
+
+    bool atEnd() const { return pos == data.size(); }
+
+private:
+    const std::string& data;
+    size_t pos = 0;
+};
+
+bool isEntry(const fs::directory_entry& entry) {
+    return entry.is_regular_file() && entry.path().extension() == kExtension;
+}
+
+} // namespace
+
+CacheKey makeCacheKey(const ProductTable& products,
+                      const GlobalConstraints& globalConstraints,
+                      const std::vector<Objective>& objectives) {
+    CanonicalHash exact, structure;
+    exact.addWord(kVersion);
+    exact.addWord(products.size());
+    structure.addWord(products.size());
+    for (size_t i = 0; i < products.size(); ++i) {
+        exact.addString(products.name(i));
+        structure.addString(products.name(i));
+    }
+    for (auto field : kProductFields) {
+        for (double value : products.column(field)) {
+            exact.addDouble(value);
+        }
+    }
+    for (double value : {globalConstraints.budgetMin, globalConstraints.budgetMax,
+                         globalConstraints.profitMin, globalConstraints.profitMax,
+                         globalConstraints.manHoursMin, globalConstraints.manHoursMax}) {
+        exact.addDouble(value);
+    }
+
+    std::vector<Objective> sorted = objectives;
+    std::sort(sorted.begin(), sorted.end(), [](const Objective& a, const Objective& b) {
+        return std::tie(a.type, a.name, a.rank) < std::tie(b.type, b.name, b.rank);
+    });
+    exact.addWord(sorted.size());
+    for (const Objective& objective : sorted) {
+        exact.addString(objective.type);
+        exact.addString(objective.name);
+        exact.addWord(static_cast<uint64_t>(objective.rank));
+    }
+    return {exact.hex(true), structure.hex(false)};
+}
+
+const char* cacheLookupName(CacheLookup lookup) {
+    switch (lookup) {
+        case CacheLookup::Miss: return "miss";
+        case CacheLookup::Near: return "near";
+        case CacheLookup::Exact: return "exact";
+        default: return "off";
+    }
+}
+
+CacheStats solutionCacheStats() {
+    CacheStats stats;
+    stats.exactHits = exactHits.load();
+    stats.nearHits = nearHits.load();
+    stats.misses = misses.load();
+    stats.stores = stores.load();
+    stats.evictions = evictions.load();
+    return stats;
+}
+
+SolutionCache::SolutionCache(const std::string& directory, uint64_t maxBytes)
+    : directory(directory), maxBytes(maxBytes) {
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (!fs::is_directory(directory)) {
+        throw std::runtime_error("Failed to create cache directory: " + directory);
+    }
+}
+
+CacheLookup SolutionCache::lookup(const CacheKey& key, CachedSolution& solution) {
+    std::error_code error;
+    fs::path exactPath = fs::path(directory) / (key.structure + "-" + key.exact + kExtension);
+    if (load(exactPath.string(), &key, solution)) {
+        fs::last_write_time(exactPath, fs::file_time_type::clock::now(), error);
+        exactHits.fetch_add(1, std::memory_order_relaxed);
+        return CacheLookup::Exact;
+    }
+
+    // Newest entry for the same catalog, another process may evict as we scan
+    fs::path newest;
+    fs::file_time_type newestTime = fs::file_time_type::min();
+    std::string prefix = key.structure + "-";
+    for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        if (!isEntry(*it) || it->path().filename().string().compare(0, prefix.size(), prefix) != 0) continue;
+        std::error_code entryError;
+        fs::file_time_type time = it->last_write_time(entryError);
+        if (!entryError && time > newestTime) {
+            newest = it->path();
+            newestTime = time;
+        }
+    }
+    if (!newest.empty() && load(newest.string(), nullptr, solution)) {
+        fs::last_write_time(newest, fs::file_time_type::clock::now(), error);
+        nearHits.fetch_add(1, std::memory_order_relaxed);
+        return CacheLookup::Near;
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return CacheLookup::Miss;
+}
+
+bool SolutionCache::load(const std::string& path, const CacheKey* exactKey, CachedSolution& solution) const {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    EntryReader reader(data);
+    char magic[4];
+    uint32_t version = 0, columns = 0, rows = 0;
+    char exact[32];
+    if (!reader.read(magic) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !reader.read(version) || version != kVersion || !reader.read(exact)) {
+        return false;
+    }
+    if (exactKey && std::string(exact, sizeof(exact)) != exactKey->exact) {
+        return false;
+    }
+
+    CachedSolution loaded;
+    bool ok = reader.read(columns) && reader.read(rows) && reader.read(loaded.objectiveValue) &&
+              reader.readArray(loaded.columnValues, columns) && reader.readArray(loaded.rowActivities, rows) &&
+              reader.readArray(loaded.columnStatus, columns) && reader.readArray(loaded.rowStatus, rows) &&
+              reader.atEnd();
+    if (!ok) return false;
+    for (std::vector<BasisStatus>* statuses : {&loaded.columnStatus, &loaded.rowStatus}) {
+        for (BasisStatus status : *statuses) {
+            if (status != BasisStatus::Basic && status != BasisStatus::AtLower && status != BasisStatus::AtUpper) {
+                return false;
+            }
+        }
+    }
+    solution = std::move(loaded);
+    return true;
+}
+
+void SolutionCache::store(const CacheKey& key, const CachedSolution& solution) {
+    std::string data;
+    data.append(kMagic, sizeof(kMagic));
+    appendValue(data, kVersion);
+    data.append(key.exact);
+    appendValue(data, static_cast<uint32_t>(solution.columnValues.size()));
+    appendValue(data, static_cast<uint32_t>(solution.rowActivities.size()));
+    appendValue(data, solution.objectiveValue);
+    appendArray(data, solution.columnValues);
+    appendArray(data, solution.rowActivities);
+    appendArray(data, solution.columnStatus);
+    appendArray(data, solution.rowStatus);
+
+    // Unique temporary name per writer, the rename makes the entry visible whole
+    static std::atomic<uint64_t> sequence{0};
+    fs::path path = fs::path(directory) / (key.structure + "-" + key.exact + kExtension);
+    fs::path temporary = path;
+    temporary += ".tmp" + std::to_string(getpid()) + "-" + std::to_string(sequence.fetch_add(1));
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        if (!out.is_open() || !out.write(data.data(), static_cast<std::streamsize>(data.size()))) {
+            std::error_code error;
+            fs::remove(temporary, error);
+            return;  // A full or read-only cache only costs the next run a solve
+        }
+    }
+    std::error_code error;
+    fs::rename(temporary, path, error);
+    if (error) {
+        fs::remove(temporary, error);
+        return;
+    }
+    stores.fetch_add(1, std::memory_order_relaxed);
+    evict();
+}
+
+void SolutionCache::evict() {
+    struct Entry {
+        fs::path path;
+        fs::file_time_type time;
+        uintmax_t size;
+    };
+    std::vector<Entry> entries;
+    uintmax_t total = 0;
+    std::error_code error;
+    for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        if (!isEntry(*it)) continue;
+        std::error_code entryError;
+        Entry entry{it->path(), it->last_write_time(entryError), it->file_size(entryError)};
+        if (entryError) continue;
+        total += entry.size;
+        entries.push_back(std::move(entry));
+    }
+    if (total <= maxBytes) return;
+
+    // Least recently used first
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    for (const Entry& entry : entries) {
+        if (total <= maxBytes) break;
+        if (fs::remove(entry.path, error)) {
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        total -= entry.size;
+    }
+}
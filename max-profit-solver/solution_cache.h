@@ -0,0 +1,72 @@
+// solution_cache.h
+#ifndef SOLUTION_CACHE_H
+#define SOLUTION_CACHE_H
+
+#include "input.h"
+#include "structured_solver.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Optimal solution and basis of one model, columns then rows
+struct CachedSolution {
+    double objectiveValue = 0.0;
+    std::vector<double> columnValues;
+    std::vector<double> rowActivities;
+    std::vector<BasisStatus> columnStatus;
+    std::vector<BasisStatus> rowStatus;
+};
+
+struct CacheKey {
+    std::string exact;      // 128-bit hash of every normalized input value
+    std::string structure;  // 64-bit hash of the product names in table order
+};
+
+// Objectives are sorted and -0.0/NaN normalized first, so equivalent inputs
+// share a key however the config was written
+CacheKey makeCacheKey(const ProductTable& products,
+                      const GlobalConstraints& globalConstraints,
+                      const std::vector<Objective>& objectives);
+
+enum class CacheLookup {
+    Off,    // No cache configured
+    Miss,
+    Near,   // Same products and order, other values: basis to warm start from
+    Exact   // Identical inputs: stored solution used as is
+};
+
+const char* cacheLookupName(CacheLookup lookup);
+
+// Process-wide counters over every SolutionCache
+struct CacheStats {
+    uint64_t exactHits = 0;
+    uint64_t nearHits = 0;
+    uint64_t misses = 0;
+    uint64_t stores = 0;
+    uint64_t evictions = 0;
+};
+
+CacheStats solutionCacheStats();
+
+// Directory of <structure>-<exact>.pms files, one per solved model. Files
+// are written to a temporary name and renamed, so concurrent batch workers
+// and processes may share a directory. Hits refresh a file's modification
+// time and the least recently used files are evicted above maxBytes.
+class SolutionCache {
+public:
+    SolutionCache(const std::string& directory, uint64_t maxBytes);
+
+    // Exact match, else the most recently used entry with the same structure
+    CacheLookup lookup(const CacheKey& key, CachedSolution& solution);
+
+    void store(const CacheKey& key, const CachedSolution& solution);
+
+private:
+    std::string directory;
+    uint64_t maxBytes;
+
+    bool load(const std::string& path, const CacheKey* exactKey, CachedSolution& solution) const;
+    void evict();
+};
+
+#endif // SOLUTION_CACHE_H
@@ -0,0 +1,160 @@
+#include "catalog_generator.h"
+#include "solution_cache.h"
+#include "solver.h"
+#include "test_util.h"
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+CachedSolution sampleSolution(size_t columns, size_t rows, double scale) {
+    CachedSolution solution;
+    solution.objectiveValue = -123.5 * scale;
+    for (size_t j = 0; j < columns; ++j) {
+        solution.columnValues.push_back(scale * static_cast<double>(j) / 3.0);
+        solution.columnStatus.push_back(j % 3 == 0 ? BasisStatus::Basic : j % 3 == 1 ? BasisStatus::AtLower
+                                                                                      : BasisStatus::AtUpper);
+    }
+    for (size_t r = 0; r < rows; ++r) {
+        solution.rowActivities.push_back(scale * static_cast<double>(r) * 1.5);
+        solution.rowStatus.push_back(r % 2 == 0 ? BasisStatus::AtUpper : BasisStatus::Basic);
+    }
+    return solution;
+}
+
+void checkSameSolution(const CachedSolution& actual, const CachedSolution& expected) {
+    CHECK(actual.objectiveValue == expected.objectiveValue);
+    CHECK(actual.columnValues == expected.columnValues);
+    CHECK(actual.rowActivities == expected.rowActivities);
+    CHECK(actual.columnStatus == expected.columnStatus);
+    CHECK(actual.rowStatus == expected.rowStatus);
+}
+
+ProductTable sampleCatalog(size_t count) {
+    CatalogSpec spec;
+    spec.products = count;
+    spec.seed = 5;
+    return generateCatalog(spec);
+}
+
+} // namespace
+
+TEST_CASE(cacheKeyIgnoresObjectiveOrderAndZeroSign) {
+    ProductTable products = sampleCatalog(20);
+    GlobalConstraints globals = generateGlobals(products, 0.3);
+    std::vector<Objective> objectives = defaultObjectives();
+    CacheKey key = makeCacheKey(products, globals, objectives);
+
+    std::vector<Objective> reversed(objectives.rbegin(), objectives.rend());
+    GlobalConstraints negativeZero = globals;
+    negativeZero.manHoursMin = -0.0;
+    CHECK(makeCacheKey(products, negativeZero, reversed).exact == key.exact);
+
+    // Another value keeps the structure, another name changes it
+    GlobalConstraints tighter = globals;
+    tighter.budgetMax *= 0.9;
+    CacheKey changed = makeCacheKey(products, tighter, objectives);
+    CHECK(changed.exact != key.exact);
+    CHECK(changed.structure == key.structure);
+    Product renamed = products.get(0);
+    renamed.name = "Renamed";
+    ProductTable other = products;
+    other.insertOrAssign(renamed);
+    CHECK(makeCacheKey(other, globals, objectives).structure != key.structure);
+}
+
+TEST_CASE(cacheRoundTripsSolutions) {
+    const std::string directory = scratchPath("cache_round_trip");
+    SolutionCache cache(directory, 1 << 20);
+    CacheKey key{std::string(32, 'a'), std::string(16, 'b')};
+    CachedSolution stored = sampleSolution(7, 16, 1.0);
+    cache.store(key, stored);
+
+    CachedSolution loaded;
+    CHECK(cache.lookup(key, loaded) == CacheLookup::Exact);
+    checkSameSolution(loaded, stored);
+
+    // Same structure, other values: the stored basis comes back as a warm start
+    CachedSolution near;
+    CHECK(cache.lookup({std::string(32, 'c'), key.structure}, near) == CacheLookup::Near);
+    checkSameSolution(near, stored);
+
+    CachedSolution missed;
+    CHECK(cache.lookup({std::string(32, 'c'), std::string(16, 'd')}, missed) == CacheLookup::Miss);
+    CHECK(missed.columnValues.empty());
+}
+
+TEST_CASE(cacheIgnoresDamagedEntries) {
+    const std::string directory = scratchPath("cache_damaged");
+    SolutionCache cache(directory, 1 << 20);
+    CacheKey key{std::string(32, 'e'), std::string(16, 'f')};
+    cache.store(key, sampleSolution(5, 12, 2.0));
+
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) - 3);
+    }
+    CachedSolution loaded;
+    CHECK(cache.lookup(key, loaded) == CacheLookup::Miss);
+}
+
+TEST_CASE(cacheEvictsLeastRecentlyUsed) {
+    const std::string directory = scratchPath("cache_evict");
+    CachedSolution solution = sampleSolution(100, 200, 1.0);
+    // Room for two entries of this size, not three
+    SolutionCache probe(scratchPath("cache_probe"), 1 << 20);
+    probe.store({std::string(32, '0'), std::string(16, '0')}, solution);
+    uintmax_t entrySize = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(scratchPath("cache_probe"))) {
+        entrySize = entry.file_size();
+    }
+    SolutionCache cache(directory, 2 * entrySize + entrySize / 2);
+
+    CacheKey first{std::string(32, '1'), std::string(16, '1')};
+    CacheKey second{std::string(32, '2'), std::string(16, '2')};
+    CacheKey third{std::string(32, '3'), std::string(16, '3')};
+    CachedSolution loaded;
+    cache.store(first, solution);
+    cache.store(second, solution);
+    CHECK(cache.lookup(first, loaded) == CacheLookup::Exact);  // Now the most recently used
+    cache.store(third, solution);
+    CHECK(cache.lookup(first, loaded) == CacheLookup::Exact);
+    CHECK(cache.lookup(third, loaded) == CacheLookup::Exact);
+    CHECK(cache.lookup(second, loaded) == CacheLookup::Miss);
+}
+
+TEST_CASE(cachedSolveMatchesFreshSolve) {
+    ProductTable products = sampleCatalog(30);
+    GlobalConstraints globals = generateGlobals(products, 0.3);
+    SolverOptions options;
+    options.verbose = false;
+    options.cacheDir = scratchPath("cache_solver");
+    SolveResult fresh = Solver(products, globals, defaultObjectives(), options).solve();
+    SolveResult cached = Solver(products, globals, defaultObjectives(), options).solve();
+    CHECK(fresh.status == 0);
+    CHECK(fresh.cache == CacheLookup::Miss);
+    CHECK(cached.cache == CacheLookup::Exact);
+    CHECK(cached.status == 0);
+    CHECK(cached.objectiveValue == fresh.objectiveValue);
+    CHECK(cached.totalBudgetUsed == fresh.totalBudgetUsed);
+}
+
+TEST_CASE(nearHitWarmStartsClp) {
+    ProductTable products = sampleCatalog(30);
+    GlobalConstraints globals = generateGlobals(products, 0.3);
+    SolverOptions options;
+    options.verbose = false;
+    options.engine = SolverEngine::Clp;  // The fast path would not use the cached basis
+    options.cacheDir = scratchPath("cache_near");
+    CHECK(Solver(products, globals, defaultObjectives(), options).solve().status == 0);
+
+    // Same catalog, another budget: Clp starts from the stored basis
+    globals.budgetMax *= 0.95;
+    SolveResult warm = Solver(products, globals, defaultObjectives(), options).solve();
+    options.cacheDir.clear();
+    SolveResult cold = Solver(products, globals, defaultObjectives(), options).solve();
+    CHECK(warm.cache == CacheLookup::Near);
+    CHECK(warm.status == 0);
+    CHECK(cold.status == 0);
+    CHECK_NEAR(warm.objectiveValue, cold.objectiveValue, 1e-9);
+    CHECK_NEAR(warm.totalBudgetUsed, cold.totalBudgetUsed, 1e-9);
+}
@@ -1,122 +1,676 @@
 #include "solver.h"
+#include "metrics.h"
+#include "thread_pool.h"
+#include "validation_kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <memory>
 #include <numeric>
+#include <thread>
 
-Solver::Solver(const std::unordered_map<std::string, Product>& products,
+const char* solveStatusName(int status) {
+    switch (status) {
+        case 0: return "optimal";
+        case 1: return "primal_infeasible";
+        case 2: return "dual_infeasible";
+        case 3: return "iteration_limit";
+        case 4: return "solver_error";
+        case 5: return "stopped";
+        default: return "unknown";
+    }
+}
+
+Solver::Solver(const ProductTable& products,
                const GlobalConstraints& globalConstraints,
-               const std::vector<Objective>& objectives)
-    : products(products), globalConstraints(globalConstraints), objectives(objectives) {}
+               const std::vector<Objective>& objectives,
+               const SolverOptions& options)
+    : products(products), globalConstraints(globalConstraints), objectives(objectives), options(options) {}
+
+SolveResult Solver::solve() {
+    if (!options.verbose) {
+        model.setLogLevel(0);
+    }
+    SolveResult result;
+    {
+        PhaseTimer timer(MetricsPhase::SetupModel, &result.phases.setupModel);
+        setupModel();
+    }
+    {
+        PhaseTimer timer(MetricsPhase::ApplyConstraints, &result.phases.applyConstraints);
+        applyConstraints();
+    }
+    {
+        PhaseTimer timer(MetricsPhase::DefineObjective, &result.phases.defineObjective);
+        defineObjectiveFunction();
+    }
+    modelLoaded = false;
+    structured = StructuredSolution();
+    warmStartFromCache = false;
+    lockRowNames.clear();
+
+    std::unique_ptr<SolutionCache> cache;
+    CacheKey cacheKey;
+    {
+        PhaseTimer timer(MetricsPhase::Solve, &result.phases.solve);
+        // Lexicographic and integer solves differ from the plain model the cache holds
+        if (!options.cacheDir.empty() && !options.lexicographic && !options.integerUnits) {
+            cache = std::make_unique<SolutionCache>(options.cacheDir, options.cacheMaxBytes);
+            cacheKey = makeCacheKey(products, globalConstraints, objectives);
+            lookupCache(*cache, cacheKey, result);
+        }
+        if (options.lexicographic) {
+            if (options.integerUnits) {
+                throw std::invalid_argument("Integer units cannot be combined with a lexicographic solve");
+            }
+            if (!options.sensitivityResultsFile.empty()) {
+                throw std::invalid_argument("Sensitivity results cannot be combined with a lexicographic solve");
+            }
+            solveLexicographic(result);
+        } else {
+            if (result.cache != CacheLookup::Exact && options.engine == SolverEngine::Auto) {
+                structured = solveStructured(lpView());
+            }
+            // An exact cache hit is served as if the fast path had produced it, basis included
+            if (structured.outcome == StructuredSolution::Optimal) {
+                result.status = 0;
+                result.objectiveValue = structured.objectiveValue;
+            } else {
+                // Other shapes, and infeasible models so the status is Clp's
+                ensureModelLoaded();
+                result.status = model.status();
+                result.iterations = model.numberIterations();
+                result.objectiveValue = model.objectiveValue();
+                result.algorithm = lastAlgorithm;
+            }
+            if (options.integerUnits && result.status == 0) {
+                solveWholeUnits(result);
+            }
+        }
+        if (cache && result.status == 0 && result.cache != CacheLookup::Exact) {
+            cache->store(cacheKey, currentSolution());
+        }
+    }
+    recordSolveMetrics(result.status, result.iterations, static_cast<int>(rowLower.size()),
+                       static_cast<int>(products.size()));
+    if (options.verbose && result.cache != CacheLookup::Off) {
+        std::cout << "Solution cache: " << cacheLookupName(result.cache) << "\n";
+    }
+    if (options.verbose && result.lexicographicStages > 0) {
+        std::cout << "Lexicographic solve: " << result.lexicographicStages << " stages\n";
+        for (const std::string& name : lockRowNames) {
+            std::cout << "  locked " << name << "\n";
+        }
+    }
+    if (options.verbose && options.integerUnits && result.integerNodes > 0) {
+        double gap = result.status == 0 ? (result.objectiveValue - result.integerBound) /
+                                              std::max(1.0, std::abs(result.objectiveValue)) : 0.0;
+        std::cout << "Branch and bound: " << result.integerNodes << " nodes, bound " << result.integerBound
+                  << ", gap " << gap * 100.0 << "%\n";
+    }
+    if (options.verbose && result.algorithm != LpAlgorithm::Auto) {
+        std::cout << "Clp algorithm: " << lpAlgorithmName(result.algorithm) << " (" << result.iterations
+                  << " iterations)\n";
+    }
+
+    {
+        PhaseTimer timer(MetricsPhase::Report, &result.phases.report);
+        computeTotals(result);
+
+        if (!options.sensitivityReportFile.empty() && result.status == 0) {
+            SensitivityReport report = buildSensitivityReport();
+            report.solveMillis = result.phases.solve;
+            std::ofstream out(options.sensitivityReportFile);
+            if (!out.is_open()) {
+                throw std::runtime_error("Failed to open sensitivity report file: " + options.sensitivityReportFile);
+            }
+            writeSensitivityReport(report, out);
+        }
+
+        if (!options.resultsFile.empty() && result.status == 0) {
+            writeSolutionResults();
+        }
 
-void Solver::solve() {
+        // Both read the plan through columnSolution(), no Clp solve needed
+        if (options.verbose) {
+            displayResults();
+            validateSolution();
+        }
+    }
+    if (options.verbose) {
+        performSensitivityAnalysis();
+    }
+
+    if (!options.parametric.target.empty() && result.status == 0) {
+        ParametricCurve curve = traceParametric();
+        if (options.verbose) {
+            displayParametricCurve(curve);
+        }
+        if (!options.parametric.outputFile.empty()) {
+            std::ofstream out(options.parametric.outputFile);
+            if (!out.is_open()) {
+                throw std::runtime_error("Failed to open parametric output file: " + options.parametric.outputFile);
+            }
+            writeParametricCurve(curve, out);
+        }
+    }
+
+    if (options.monteCarlo.samples > 0 && result.status == 0) {
+        MonteCarloReport report = runMonteCarlo();
+        if (options.verbose) {
+            displayMonteCarlo(report);
+        }
+        if (!options.monteCarlo.outputFile.empty()) {
+            std::ofstream out(options.monteCarlo.outputFile);
+            if (!out.is_open()) {
+                throw std::runtime_error("Failed to open Monte Carlo output file: " + options.monteCarlo.outputFile);
+            }
+            writeMonteCarloReport(report, out);
+        }
+    }
+    return result;
+}
+
+void Solver::computeTotals(SolveResult& result) const {
+    const double* solution = columnSolution();
+    const auto& profitMin = products.column(&Product::profitMin);
+    const auto& profitMax = products.column(&Product::profitMax);
+    for (size_t i = 0; i < products.size(); ++i) {
+        double profitPercent = (profitMin[i] + profitMax[i]) / 2.0;
+        double unitsProduced = solution[i];
+        result.totalProfit += unitsProduced * avgCosts[i] * (profitPercent / 100.0);
+        result.totalBudgetUsed += unitsProduced * avgCosts[i];
+        result.totalManHoursUsed += unitsProduced * avgManHours[i];
+    }
+}
+
+void Solver::buildModel() {
+    assembleModel();
+    loadModel();
+}
+
+void Solver::assembleModel() {
     setupModel();
     applyConstraints();
     defineObjectiveFunction();
-    model.primal();
-    displayResults();
-    validateSolution();
-    performSensitivityAnalysis();
 }
 
-void Solver::setupModel() {
-    size_t numProducts = products.size();
-    model.resize(0, numProducts);
+LpView Solver::lpView() const {
+    LpView lp;
+    lp.numColumns = static_cast<int>(products.size());
+    lp.numRows = static_cast<int>(rowLower.size());
+    lp.columnStarts = columnStarts.data();
+    lp.rowIndices = rowIndices.data();
+    lp.elements = elements.data();
+    lp.columnLower = lowerBounds.data();
+    lp.columnUpper = upperBounds.data();
+    lp.objective = blendedObjective.data();
+    lp.rowLower = rowLower.data();
+    lp.rowUpper = rowUpper.data();
+    return lp;
+}
 
-    objectiveCoefficients.resize(numProducts, 0.0);
-    lowerBounds.resize(numProducts, 0.0);
-    upperBounds.resize(numProducts, 0.0);
-    avgCosts.resize(numProducts, 0.0);
-    avgManHours.resize(numProducts, 0.0);
+void Solver::loadModel() {
+    // Hand the whole model to Clp at once instead of growing it row by row
+    model.loadProblem(static_cast<int>(products.size()), static_cast<int>(rowLower.size()),
+                      columnStarts.data(), rowIndices.data(), elements.data(),
+                      lowerBounds.data(), upperBounds.data(), blendedObjective.data(),
+                      rowLower.data(), rowUpper.data());
+    model.setOptimizationDirection(1);
+    modelLoaded = true;
+}
 
-    size_t index = 0;
-    for (const auto& [name, product] : products) {
-        avgCosts[index] = (product.costMin + product.costMax) / 2.0;
-        double avgProfit = (product.profitMin + product.profitMax) / 200.0;
-        avgManHours[index] = (product.manHourPerUnitMin + product.manHourPerUnitMax) / 2.0;
+static ClpSimplex::Status clpStatus(BasisStatus status) {
+    switch (status) {
+        case BasisStatus::AtLower: return ClpSimplex::atLowerBound;
+        case BasisStatus::AtUpper: return ClpSimplex::atUpperBound;
+        default: return ClpSimplex::basic;
+    }
+}
 
-        objectiveCoefficients[index] = avgCosts[index] * avgProfit;
-        lowerBounds[index] = product.demandMin;
-        upperBounds[index] = product.demandMax;
+void Solver::ensureModelLoaded() {
+    if (modelLoaded) {
+        return;
+    }
+    loadModel();
+
+    // Start from the structured solution and its basis, primal then only
+    // has to confirm optimality instead of solving from scratch
+    WarmStart warmStart = WarmStart::None;
+    if (structured.outcome != StructuredSolution::Optimal && warmStartFromCache) {
+        warmStart = WarmStart::Other;
+        // Bounds may have moved since, primal repairs the cached basis
+        model.createStatus();
+        std::copy(cachedStart.columnValues.begin(), cachedStart.columnValues.end(), model.primalColumnSolution());
+        std::copy(cachedStart.rowActivities.begin(), cachedStart.rowActivities.end(), model.primalRowSolution());
+        for (size_t column = 0; column < cachedStart.columnStatus.size(); ++column) {
+            model.setColumnStatus(static_cast<int>(column), clpStatus(cachedStart.columnStatus[column]));
+        }
+        for (size_t row = 0; row < cachedStart.rowStatus.size(); ++row) {
+            model.setRowStatus(static_cast<int>(row), clpStatus(cachedStart.rowStatus[row]));
+        }
+    } else if (structured.outcome == StructuredSolution::Optimal) {
+        warmStart = WarmStart::Optimal;
+        model.createStatus();
+        std::copy(structured.columnValues.begin(), structured.columnValues.end(), model.primalColumnSolution());
+        std::copy(structured.rowActivities.begin(), structured.rowActivities.end(), model.primalRowSolution());
+        for (size_t column = 0; column < structured.columnStatus.size(); ++column) {
+            model.setColumnStatus(static_cast<int>(column), clpStatus(structured.columnStatus[column]));
+        }
+        for (size_t row = 0; row < structured.rowStatus.size(); ++row) {
+            model.setRowStatus(static_cast<int>(row), clpStatus(structured.rowStatus[row]));
+        }
+    }
+    lastAlgorithm = runLpAlgorithm(model, options.algorithm, warmStart, options.presolve);
+}
 
-        model.setColumnLower(index, lowerBounds[index]);
-        model.setColumnUpper(index, upperBounds[index]);
-        ++index;
+void Solver::lookupCache(SolutionCache& cache, const CacheKey& key, SolveResult& result) {
+    result.cache = cache.lookup(key, cachedStart);
+    // Entries of another row layout cannot seed this model
+    if (result.cache != CacheLookup::Miss &&
+        (cachedStart.columnValues.size() != products.size() || cachedStart.rowActivities.size() != rowLower.size())) {
+        result.cache = CacheLookup::Miss;
     }
+    if (result.cache == CacheLookup::Exact) {
+        structured.outcome = StructuredSolution::Optimal;
+        structured.objectiveValue = cachedStart.objectiveValue;
+        structured.columnValues = cachedStart.columnValues;
+        structured.rowActivities = cachedStart.rowActivities;
+        structured.columnStatus = cachedStart.columnStatus;
+        structured.rowStatus = cachedStart.rowStatus;
+        result.status = 0;
+        result.objectiveValue = cachedStart.objectiveValue;
+    }
+    warmStartFromCache = result.cache == CacheLookup::Near;
 }
 
-void Solver::applyConstraints() {
-    int index = 0;
-    for (const auto& [name, product] : products) {
-        double avgCost = avgCosts[index];
-        double avgManHour = avgManHours[index];
-        int columnIndex = index;
+CachedSolution Solver::currentSolution() const {
+    CachedSolution solution;
+    if (!modelLoaded) {
+        solution.objectiveValue = structured.objectiveValue;
+        solution.columnValues = structured.columnValues;
+        solution.rowActivities = structured.rowActivities;
+        solution.columnStatus = structured.columnStatus;
+        solution.rowStatus = structured.rowStatus;
+        return solution;
+    }
 
-        model.addRow(1, &columnIndex, &avgCost, product.budgetMin, product.budgetMax);
-        model.addRow(1, &columnIndex, &avgManHour, 0.0, product.totalManHoursMax);
-        ++index;
+    auto basisStatus = [](ClpSimplex::Status status) {
+        switch (status) {
+            case ClpSimplex::atUpperBound: return BasisStatus::AtUpper;
+            case ClpSimplex::atLowerBound:
+            case ClpSimplex::isFixed: return BasisStatus::AtLower;
+            default: return BasisStatus::Basic;
+        }
+    };
+    int numColumns = model.numberColumns();
+    int numRows = model.numberRows();
+    solution.objectiveValue = model.objectiveValue();
+    solution.columnValues.assign(model.getColSolution(), model.getColSolution() + numColumns);
+    solution.rowActivities.assign(model.getRowActivity(), model.getRowActivity() + numRows);
+    for (int column = 0; column < numColumns; ++column) {
+        solution.columnStatus.push_back(basisStatus(model.getColumnStatus(column)));
+    }
+    for (int row = 0; row < numRows; ++row) {
+        solution.rowStatus.push_back(basisStatus(model.getRowStatus(row)));
     }
+    return solution;
+}
+
+const double* Solver::columnSolution() const {
+    return modelLoaded ? model.getColSolution() : structured.columnValues.data();
+}
+
+void Solver::setupModel() {
+    size_t numProducts = products.size();
 
-    std::vector<int> indices(products.size());
-    std::iota(indices.begin(), indices.end(), 0);
+    const auto& costMin = products.column(&Product::costMin);
+    const auto& costMax = products.column(&Product::costMax);
+    const auto& profitMin = products.column(&Product::profitMin);
+    const auto& profitMax = products.column(&Product::profitMax);
+    const auto& manHourPerUnitMin = products.column(&Product::manHourPerUnitMin);
+    const auto& manHourPerUnitMax = products.column(&Product::manHourPerUnitMax);
 
-    model.addRow(indices.size(), indices.data(), avgCosts.data(), globalConstraints.budgetMin, globalConstraints.budgetMax);
-    model.addRow(indices.size(), indices.data(), avgManHours.data(), 0.0, globalConstraints.manHoursMax);
+    objectiveCoefficients.resize(numProducts);
+    avgCosts.resize(numProducts);
+    avgManHours.resize(numProducts);
+    lowerBounds = products.column(&Product::demandMin);
+    upperBounds = products.column(&Product::demandMax);
+
+    // Straight array arithmetic over the table columns
+    for (size_t i = 0; i < numProducts; ++i) {
+        avgCosts[i] = (costMin[i] + costMax[i]) / 2.0;
+        avgManHours[i] = (manHourPerUnitMin[i] + manHourPerUnitMax[i]) / 2.0;
+        objectiveCoefficients[i] = avgCosts[i] * (profitMin[i] + profitMax[i]) / 200.0;
+    }
 }
 
-void Solver::defineObjectiveFunction() {
-    double weightProfit = 0.0;
-    double weightResource = 0.0;
-    double weightBudget = 0.0;
+void Solver::applyConstraints() {
+    // Rows 2i and 2i+1 are product i's budget and man-hour rows, the last
+    // two rows are the global budget and man-hours. Every column therefore
+    // has exactly four entries, which we lay out column-major in one pass.
+    size_t numProducts = products.size();
+    globalBudgetRow = static_cast<int>(2 * numProducts);
+    globalManHoursRow = globalBudgetRow + 1;
+
+    rowLower.assign(2 * numProducts + 2, 0.0);
+    rowUpper.assign(2 * numProducts + 2, 0.0);
+    columnStarts.resize(numProducts + 1);
+    rowIndices.resize(4 * numProducts);
+    elements.resize(4 * numProducts);
+
+    const auto& budgetMin = products.column(&Product::budgetMin);
+    const auto& budgetMax = products.column(&Product::budgetMax);
+    const auto& totalManHoursMax = products.column(&Product::totalManHoursMax);
 
+    for (size_t index = 0; index < numProducts; ++index) {
+        int budgetRow = static_cast<int>(2 * index);
+        rowLower[budgetRow] = budgetMin[index];
+        rowUpper[budgetRow] = budgetMax[index];
+        rowLower[budgetRow + 1] = 0.0;
+        rowUpper[budgetRow + 1] = totalManHoursMax[index];
+
+        CoinBigIndex start = static_cast<CoinBigIndex>(4 * index);
+        columnStarts[index] = start;
+        rowIndices[start] = budgetRow;
+        rowIndices[start + 1] = budgetRow + 1;
+        rowIndices[start + 2] = globalBudgetRow;
+        rowIndices[start + 3] = globalManHoursRow;
+        elements[start] = avgCosts[index];
+        elements[start + 1] = avgManHours[index];
+        elements[start + 2] = avgCosts[index];
+        elements[start + 3] = avgManHours[index];
+    }
+    columnStarts[numProducts] = static_cast<CoinBigIndex>(4 * numProducts);
+
+    rowLower[globalBudgetRow] = globalConstraints.budgetMin;
+    rowUpper[globalBudgetRow] = globalConstraints.budgetMax;
+    rowLower[globalManHoursRow] = 0.0;
+    rowUpper[globalManHoursRow] = globalConstraints.manHoursMax;
+}
+
+ObjectiveWeights blendWeights(const std::vector<Objective>& objectives) {
+    ObjectiveWeights weights;
     for (const auto& objective : objectives) {
         if (objective.name == "profit" && objective.type == "maximize") {
-            weightProfit = 1.0 / objective.rank;
+            weights.profit = 1.0 / objective.rank;
         } else if (objective.name == "resource_usage" && objective.type == "minimize") {
-            weightResource = 1.0 / objective.rank;
+            weights.resource = 1.0 / objective.rank;
         } else if (objective.name == "budget_usage" && objective.type == "maximize") {
-            weightBudget = 1.0 / objective.rank;
+            weights.budget = 1.0 / objective.rank;
         }
     }
+    return weights;
+}
+
+void Solver::defineObjectiveFunction() {
+    ObjectiveWeights weights = blendWeights(objectives);
+    profitWeight = weights.profit;
+    resourceWeight = weights.resource;
+    budgetWeight = weights.budget;
 
+    blendedObjective.resize(objectiveCoefficients.size());
     for (size_t i = 0; i < objectiveCoefficients.size(); ++i) {
-        model.setObjectiveCoefficient(i, weightProfit * objectiveCoefficients[i] -
-                                           weightResource * avgManHours[i] +
-                                           weightBudget * avgCosts[i]);
+        blendedObjective[i] = blendedCoefficient(i);
     }
+}
 
-    model.setOptimizationDirection(1);
+std::vector<Solver::LexicographicStage> Solver::lexicographicStages() const {
+    std::vector<Objective> ranked = objectives;
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const Objective& a, const Objective& b) { return a.rank < b.rank; });
+
+    // Weights in the form of blendedCoefficient on the minimizing model;
+    // objectives sharing a rank are summed into one stage
+    std::vector<LexicographicStage> stages;
+    for (const Objective& objective : ranked) {
+        if (stages.empty() || stages.back().rank != objective.rank) {
+            stages.push_back(LexicographicStage{objective.rank, 0.0, 0.0, 0.0, std::string()});
+        }
+        LexicographicStage& stage = stages.back();
+        double sense = objective.type == "maximize" ? -1.0 : 1.0;
+        if (objective.name == "profit") {
+            stage.profitWeight += sense;
+        } else if (objective.name == "resource_usage") {
+            stage.resourceWeight -= sense;
+        } else if (objective.name == "budget_usage") {
+            stage.budgetWeight += sense;
+        } else {
+            throw std::invalid_argument("Unknown objective for a lexicographic solve: " + objective.type + "_" +
+                                        objective.name);
+        }
+        stage.label += (stage.label.empty() ? "" : "+") + objective.type + "_" + objective.name;
+    }
+    if (stages.empty()) {
+        throw std::invalid_argument("A lexicographic solve needs at least one objective");
+    }
+    return stages;
+}
+
+void Solver::useStageWeights(const LexicographicStage& stage) {
+    profitWeight = stage.profitWeight;
+    resourceWeight = stage.resourceWeight;
+    budgetWeight = stage.budgetWeight;
+    for (size_t i = 0; i < blendedObjective.size(); ++i) {
+        blendedObjective[i] = blendedCoefficient(i);
+    }
+}
+
+void Solver::solveLexicographic(SolveResult& result) {
+    std::vector<LexicographicStage> stages = lexicographicStages();
+
+    // The first stage has the usual shape, so the fast path can hand Clp an
+    // optimal basis. Every later stage starts from the previous optimum.
+    useStageWeights(stages.front());
+    if (options.engine == SolverEngine::Auto) {
+        structured = solveStructured(lpView());
+    }
+    ensureModelLoaded();
+    result.algorithm = lastAlgorithm;
+    result.iterations = model.numberIterations();
+
+    for (size_t stage = 0; stage + 1 < stages.size() && model.status() == 0; ++stage) {
+        // Lock the optimum within the tolerance. The new row's slack is
+        // basic, so the basis stays valid and primal feasible.
+        double optimum = model.objectiveValue();
+        double limit = optimum + options.lexicographicTolerance * std::max(1.0, std::fabs(optimum));
+        std::vector<int> columns;
+        std::vector<double> coefficients;
+        for (size_t i = 0; i < blendedObjective.size(); ++i) {
+            if (blendedObjective[i] != 0.0) {
+                columns.push_back(static_cast<int>(i));
+                coefficients.push_back(blendedObjective[i]);
+            }
+        }
+        const double unbounded = -std::numeric_limits<double>::max();
+        int lockRow = model.numberRows();
+        model.addRow(static_cast<int>(columns.size()), columns.data(), coefficients.data(), unbounded, limit);
+        model.setRowStatus(lockRow, ClpSimplex::basic);
+        rowLower.push_back(unbounded);
+        rowUpper.push_back(limit);
+        lockRowNames.push_back("rank:" + stages[stage].label);
+
+        useStageWeights(stages[stage + 1]);
+        model.chgObjCoefficients(blendedObjective.data());
+        lastAlgorithm = runLpAlgorithm(model, options.algorithm, WarmStart::Other, false);
+        result.iterations += model.numberIterations();
+    }
+
+    result.status = model.status();
+    result.objectiveValue = model.objectiveValue();
+    result.lexicographicStages = lockRowNames.size() + 1;
+}
+
+void Solver::solveWholeUnits(SolveResult& result) {
+    ensureModelLoaded();
+    BranchAndBoundOptions search;
+    search.relativeGap = options.integerGap;
+    search.maxNodes = options.integerMaxNodes;
+    search.threads = options.threads;
+    search.algorithm = options.algorithm;
+    IntegerSolution integer = solveIntegerUnits(model, lpView(), search);
+    result.integerNodes = integer.nodes;
+    result.integerBound = integer.bound;
+    result.iterations += static_cast<int>(integer.iterations);
+    if (integer.columnValues.empty()) {
+        result.status = integer.outcome == IntegerSolution::NodeLimit ? 3 : 1;
+        return;
+    }
+
+    // Fix every column at its whole-unit value and re-solve, so the results,
+    // checks and any later analysis read the integer plan off the model. The
+    // bound arrays follow, so lpView and the sensitivity report agree with it.
+    for (size_t column = 0; column < products.size(); ++column) {
+        double units = integer.columnValues[column];
+        lowerBounds[column] = units;
+        upperBounds[column] = units;
+        model.setColumnBounds(static_cast<int>(column), units, units);
+    }
+    runLpAlgorithm(model, options.algorithm, WarmStart::Bounds, false);
+    result.status = model.status();
+    result.iterations += model.numberIterations();
+    result.objectiveValue = model.objectiveValue();
+}
+
+double Solver::columnValue(size_t column) const {
+    return columnSolution()[column];
+}
+
+void Solver::updateProduct(size_t column) {
+    ensureModelLoaded();
+    Product product = products.get(column);
+    int col = static_cast<int>(column);
+    int budgetRow = 2 * col;
+
+    if (product.demandMin != lowerBounds[column] || product.demandMax != upperBounds[column]) {
+        lowerBounds[column] = product.demandMin;
+        upperBounds[column] = product.demandMax;
+        model.setColumnBounds(col, product.demandMin, product.demandMax);
+        pendingEdits |= BoundEdit;
+    }
+    if (product.budgetMin != rowLower[budgetRow] || product.budgetMax != rowUpper[budgetRow] ||
+        product.totalManHoursMax != rowUpper[budgetRow + 1]) {
+        rowLower[budgetRow] = product.budgetMin;
+        rowUpper[budgetRow] = product.budgetMax;
+        rowUpper[budgetRow + 1] = product.totalManHoursMax;
+        model.setRowBounds(budgetRow, product.budgetMin, product.budgetMax);
+        model.setRowBounds(budgetRow + 1, 0.0, product.totalManHoursMax);
+        pendingEdits |= BoundEdit;
+    }
+
+    // Cost and man-hours are the four matrix entries of the column
+    double avgCost = (product.costMin + product.costMax) / 2.0;
+    double avgManHour = (product.manHourPerUnitMin + product.manHourPerUnitMax) / 2.0;
+    if (avgCost != avgCosts[column] || avgManHour != avgManHours[column]) {
+        avgCosts[column] = avgCost;
+        avgManHours[column] = avgManHour;
+        CoinBigIndex start = columnStarts[column];
+        for (CoinBigIndex k = start; k < start + 4; ++k) {
+            elements[k] = (k - start) % 2 == 0 ? avgCost : avgManHour;
+            model.modifyCoefficient(rowIndices[k], col, elements[k]);
+        }
+        pendingEdits |= MatrixEdit;
+    }
+
+    objectiveCoefficients[column] = avgCost * (product.profitMin + product.profitMax) / 200.0;
+    double coefficient = blendedCoefficient(column);
+    if (coefficient != blendedObjective[column]) {
+        blendedObjective[column] = coefficient;
+        model.setObjectiveCoefficient(col, coefficient);
+        pendingEdits |= ObjectiveEdit;
+    }
+}
+
+void Solver::updateGlobalConstraints() {
+    ensureModelLoaded();
+    rowLower[globalBudgetRow] = globalConstraints.budgetMin;
+    rowUpper[globalBudgetRow] = globalConstraints.budgetMax;
+    rowUpper[globalManHoursRow] = globalConstraints.manHoursMax;
+    model.setRowBounds(globalBudgetRow, globalConstraints.budgetMin, globalConstraints.budgetMax);
+    model.setRowBounds(globalManHoursRow, 0.0, globalConstraints.manHoursMax);
+    pendingEdits |= BoundEdit;
+}
+
+void Solver::updateObjectives() {
+    // A rank change reweights every column, hand Clp the whole vector at once
+    ensureModelLoaded();
+    defineObjectiveFunction();
+    model.chgObjCoefficients(blendedObjective.data());
+    pendingEdits |= ObjectiveEdit;
+}
+
+SolveResult Solver::resolve() {
+    ensureModelLoaded();
+    SolveResult result;
+    {
+        PhaseTimer timer(MetricsPhase::Solve, &result.phases.solve);
+        if (pendingEdits != 0) {
+            // The basis stays dual feasible when only bounds moved; objective
+            // and matrix edits keep it primal feasible or close to it
+            WarmStart warmStart = pendingEdits == BoundEdit ? WarmStart::Bounds : WarmStart::Other;
+            result.algorithm = runLpAlgorithm(model, options.algorithm, warmStart, false);
+            result.iterations = model.numberIterations();
+        }
+        pendingEdits = 0;
+    }
+
+    result.status = model.status();
+    result.objectiveValue = model.objectiveValue();
+    recordSolveMetrics(result.status, result.iterations, model.numberRows(), model.numberColumns());
+    computeTotals(result);
+    return result;
 }
 
 void Solver::displayResults() {
     std::cout << "\nOptimal solution found:\n";
-    std::cout << std::setw(10) << "Product" << std::setw(15) << "Cost Picked" << std::setw(15) << "Profit %"
-              << std::setw(15) << "Profit Value" << std::setw(15) << "Units" << std::setw(15) << "Man Hours"
-              << std::setw(15) << "Budget Used" << "\n";
-    std::cout << std::string(105, '-') << "\n";
 
-    const double* solution = model.getColSolution();
-    size_t index = 0;
+    const double* solution = columnSolution();
+    const auto& profitMin = products.column(&Product::profitMin);
+    const auto& profitMax = products.column(&Product::profitMax);
+    std::vector<double> profitValues(products.size());
     double totalProfit = 0.0;
     double totalBudgetUsed = 0.0;
     double totalManHoursUsed = 0.0;
 
-    for (const auto& [name, product] : products) {
+    for (size_t index = 0; index < products.size(); ++index) {
+        double profitPercent = (profitMin[index] + profitMax[index]) / 2.0;
+        profitValues[index] = solution[index] * avgCosts[index] * (profitPercent / 100.0);
+        totalProfit += profitValues[index];
+        totalBudgetUsed += solution[index] * avgCosts[index];
+        totalManHoursUsed += solution[index] * avgManHours[index];
+    }
+
+    // Large catalogs only show the most profitable rows, --results has them all
+    std::vector<size_t> shown(products.size());
+    std::iota(shown.begin(), shown.end(), 0);
+    if (options.topK != 0 && shown.size() > options.topK) {
+        std::partial_sort(shown.begin(), shown.begin() + options.topK, shown.end(), [&](size_t a, size_t b) {
+            return profitValues[a] > profitValues[b];
+        });
+        shown.resize(options.topK);
+        std::cout << "Top " << shown.size() << " of " << products.size() << " products by profit value:\n";
+    }
+
+    std::cout << std::setw(10) << "Product" << std::setw(15) << "Cost Picked" << std::setw(15) << "Profit %"
+              << std::setw(15) << "Profit Value" << std::setw(15) << "Units" << std::setw(15) << "Man Hours"
+              << std::setw(15) << "Budget Used" << "\n";
+    std::cout << std::string(105, '-') << "\n";
+
+    for (size_t index : shown) {
         double costPicked = avgCosts[index];
-        double profitPercent = (product.profitMin + product.profitMax) / 2.0;
+        double profitPercent = (profitMin[index] + profitMax[index]) / 2.0;
         double unitsProduced = solution[index];
         double manHoursUsed = unitsProduced * avgManHours[index];
         double budgetUsed = unitsProduced * costPicked;
-        double profitValue = unitsProduced * costPicked * (profitPercent / 100.0);
 
-        totalProfit += profitValue;
-        totalBudgetUsed += budgetUsed;
-        totalManHoursUsed += manHoursUsed;
-
-        std::cout << std::setw(10) << name << std::setw(15) << costPicked << std::setw(15) << profitPercent
-                  << std::setw(15) << profitValue << std::setw(15) << unitsProduced << std::setw(15) << manHoursUsed
+        std::cout << std::setw(10) << products.name(index) << std::setw(15) << costPicked << std::setw(15) << profitPercent
+                  << std::setw(15) << profitValues[index] << std::setw(15) << unitsProduced << std::setw(15) << manHoursUsed
                   << std::setw(15) << budgetUsed << "\n";
-        ++index;
     }
 
     double overallProfitPercent = (totalProfit / totalBudgetUsed) * 100;
@@ -127,59 +681,498 @@ void Solver::displayResults() {
               << std::setw(15) << totalBudgetUsed << "\n";
 }
 
-void Solver::validateSolution() {
-    std::cout << "\nValidating solution:\n";
-    const double* solution = model.getColSolution();
-    size_t index = 0;
-
-    double totalBudgetUsed = 0.0;
-    double totalManHoursUsed = 0.0;
+void Solver::writeSolutionResults() const {
+    const double* solution = columnSolution();
+    const auto& profitMin = products.column(&Product::profitMin);
+    const auto& profitMax = products.column(&Product::profitMax);
+    size_t count = products.size();
+    std::vector<double> profitPercent(count), profitValue(count), manHours(count), budgetUsed(count);
+    for (size_t index = 0; index < count; ++index) {
+        profitPercent[index] = (profitMin[index] + profitMax[index]) / 2.0;
+        budgetUsed[index] = solution[index] * avgCosts[index];
+        profitValue[index] = budgetUsed[index] * (profitPercent[index] / 100.0);
+        manHours[index] = solution[index] * avgManHours[index];
+    }
 
-    for (const auto& [name, product] : products) {
-        double costPicked = avgCosts[index];
-        double unitsProduced = solution[index];
-        double manHoursUsed = unitsProduced * avgManHours[index];
-        double budgetUsed = unitsProduced * costPicked;
+    ResultTable table;
+    table.rows = count;
+    table.labelName = "product";
+    table.label = [this](size_t row) { return std::string_view(products.name(row)); };
+    table.columns = {{"cost_picked", avgCosts.data()}, {"profit_percent", profitPercent.data()},
+                     {"profit_value", profitValue.data()}, {"units", solution},
+                     {"man_hours", manHours.data()}, {"budget_used", budgetUsed.data()}};
+    writeResultTable(table, options.resultsFile, options.resultsFormat, options.backgroundWriter);
+}
 
-        totalBudgetUsed += budgetUsed;
-        totalManHoursUsed += manHoursUsed;
+void Solver::validateSolution() {
+    std::cout << "\nValidating solution:\n";
+    UsageViolations violations = checkUsage(columnSolution(), avgCosts.data(), avgManHours.data(),
+                                            products, options.threads);
 
-        if (budgetUsed < product.budgetMin || budgetUsed > product.budgetMax) {
-            std::cerr << "Budget constraint violated for product: " << name << "\n";
+    // Name at most a screenful of products per kind, the rest are counted
+    const size_t messageLimit = 50;
+    auto report = [&](const std::vector<uint32_t>& indices, const char* constraint) {
+        for (size_t k = 0; k < indices.size() && k < messageLimit; ++k) {
+            std::cerr << constraint << " constraint violated for product: " << products.name(indices[k]) << "\n";
         }
-        if (manHoursUsed > product.totalManHoursMax) {
-            std::cerr << "Man-hours constraint violated for product: " << name << "\n";
+        if (indices.size() > messageLimit) {
+            std::cerr << constraint << " constraint violated for " << indices.size() - messageLimit << " more products\n";
         }
-        ++index;
-    }
+    };
+    report(violations.budget, "Budget");
+    report(violations.manHours, "Man-hours");
 
-    if (totalBudgetUsed > globalConstraints.budgetMax) {
+    if (violations.totalBudgetUsed > globalConstraints.budgetMax) {
         std::cerr << "Global budget constraint violated.\n";
     }
-    if (totalManHoursUsed > globalConstraints.manHoursMax) {
+    if (violations.totalManHoursUsed > globalConstraints.manHoursMax) {
         std::cerr << "Global man-hours constraint violated.\n";
     }
     std::cout << "Validation complete.\n";
 }
 
 void Solver::performSensitivityAnalysis() {
+    // Build the perturbation grid in column order, every grid is opt-in
+    std::vector<Perturbation> perturbations;
+    for (size_t index = 0; index < products.size(); ++index) {
+        auto custom = options.sensitivity.productProfitDeltas.find(products.name(index));
+        const std::vector<double>& deltas = custom != options.sensitivity.productProfitDeltas.end()
+            ? custom->second : options.sensitivity.profitDeltas;
+        for (double delta : deltas) {
+            perturbations.push_back({Perturbation::ProductProfit, index, delta});
+        }
+    }
+    for (double delta : options.sensitivity.budgetDeltas) {
+        perturbations.push_back({Perturbation::GlobalBudget, 0, delta});
+    }
+    for (double delta : options.sensitivity.manHoursDeltas) {
+        perturbations.push_back({Perturbation::GlobalManHours, 0, delta});
+    }
+    if (perturbations.empty() && options.sensitivityResultsFile.empty()) return;
+
+    // Every re-solve starts from Clp's optimal basis
+    ensureModelLoaded();
     std::cout << "\nPerforming sensitivity analysis:\n";
+    if (model.status() != 0) {
+        std::cout << "Skipped, the base model is not optimal.\n";
+        return;
+    }
+    // The rank rows lock optima of the unperturbed model, every stage would have to be re-solved
+    if (options.lexicographic) {
+        std::cout << "Skipped, perturbations of a lexicographic solve are not supported.\n";
+        return;
+    }
 
-    for (double delta = -10; delta <= 10; delta += 5) {
-        if (delta == 0) continue;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SolveResult> results = resolvePerturbations(perturbations);
+    double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 
-        std::cout << "\nAdjusting profit percentage by " << delta << "%:\n";
-        size_t index = 0;
-        for (const auto& [name, product] : products) {
-            double adjustedProfitPercent = ((product.profitMin + product.profitMax) / 2.0) * (1 + delta / 100.0);
-            double costPicked = avgCosts[index];
-            double unitsProduced = model.getColSolution()[index];
-            double profitValue = unitsProduced * costPicked * (adjustedProfitPercent / 100.0);
+    long totalIterations = 0;
+    for (const SolveResult& result : results) {
+        totalIterations += result.iterations;
+    }
+    if (!options.sensitivityResultsFile.empty()) {
+        writeSensitivityResults(perturbations, results);
+    }
+
+    // Only the perturbations that move the objective most are printed for
+    // large grids, failed re-solves first
+    std::vector<size_t> shown(perturbations.size());
+    std::iota(shown.begin(), shown.end(), 0);
+    if (options.topK != 0 && shown.size() > options.topK) {
+        double baseObjective = model.objectiveValue();
+        auto impact = [&](size_t i) {
+            return results[i].status != 0 ? std::numeric_limits<double>::infinity()
+                                          : std::abs(results[i].objectiveValue - baseObjective);
+        };
+        std::partial_sort(shown.begin(), shown.begin() + options.topK, shown.end(),
+                          [&](size_t a, size_t b) { return impact(a) > impact(b); });
+        shown.resize(options.topK);
+        std::cout << "Top " << shown.size() << " of " << perturbations.size() << " perturbations by objective change:\n";
+    }
+
+    for (size_t i : shown) {
+        const Perturbation& perturbation = perturbations[i];
+        const SolveResult& result = results[i];
+
+        if (perturbation.kind == Perturbation::ProductProfit) {
+            std::cout << "Product: " << products.name(perturbation.column) << " - Profit percentage " << perturbation.delta << "%";
+        } else if (perturbation.kind == Perturbation::GlobalBudget) {
+            std::cout << "Global budget " << perturbation.delta << "%";
+        } else {
+            std::cout << "Global man-hours " << perturbation.delta << "%";
+        }
 
-            std::cout << "Product: " << name << " - Adjusted Profit Value: " << profitValue << "\n";
-            ++index;
+        if (result.status != 0) {
+            std::cout << " - " << solveStatusName(result.status) << "\n";
+            continue;
         }
+        std::cout << " - Objective: " << result.objectiveValue << ", Profit Value: " << result.totalProfit
+                  << ", Budget Used: " << result.totalBudgetUsed << ", Man Hours: " << result.totalManHoursUsed
+                  << " (" << result.iterations << " iterations)\n";
     }
+    std::cout << "Re-optimized " << perturbations.size() << " perturbations in " << millis << " ms, "
+              << totalIterations << " simplex iterations in total.\n";
     std::cout << "Sensitivity analysis complete.\n";
 }
 
+void Solver::writeSensitivityResults(const std::vector<Perturbation>& perturbations,
+                                     const std::vector<SolveResult>& results) const {
+    size_t count = perturbations.size();
+    std::vector<double> delta(count), status(count), objective(count), profit(count), budgetUsed(count),
+        manHoursUsed(count), iterations(count);
+    for (size_t i = 0; i < count; ++i) {
+        delta[i] = perturbations[i].delta;
+        status[i] = results[i].status;
+        objective[i] = results[i].objectiveValue;
+        profit[i] = results[i].totalProfit;
+        budgetUsed[i] = results[i].totalBudgetUsed;
+        manHoursUsed[i] = results[i].totalManHoursUsed;
+        iterations[i] = results[i].iterations;
+    }
+
+    ResultTable table;
+    table.rows = count;
+    table.labelName = "target";
+    table.label = [&](size_t row) -> std::string_view {
+        switch (perturbations[row].kind) {
+            case Perturbation::ProductProfit: return products.name(perturbations[row].column);
+            case Perturbation::GlobalBudget: return "global_budget";
+            default: return "global_man_hours";
+        }
+    };
+    table.columns = {{"delta_percent", delta.data()}, {"status", status.data()}, {"objective", objective.data()},
+                     {"profit", profit.data()}, {"budget_used", budgetUsed.data()},
+                     {"man_hours_used", manHoursUsed.data()}, {"iterations", iterations.data()}};
+    writeResultTable(table, options.sensitivityResultsFile, options.resultsFormat, options.backgroundWriter);
+}
+
+std::vector<SolveResult> Solver::resolvePerturbations(const std::vector<Perturbation>& perturbations) {
+    std::vector<SolveResult> results(perturbations.size());
+    if (perturbations.empty()) return results;
+
+    int numRows = model.numberRows();
+    int numColumns = model.numberColumns();
+    std::vector<unsigned char> baseStatus(model.statusArray(), model.statusArray() + numRows + numColumns);
+    std::vector<double> baseColumnSolution(model.primalColumnSolution(), model.primalColumnSolution() + numColumns);
+    std::vector<double> baseRowSolution(model.primalRowSolution(), model.primalRowSolution() + numRows);
+
+    // No more workers, and model copies, than perturbations
+    unsigned threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(static_cast<unsigned>(std::min<size_t>(threads, perturbations.size())));
+
+    // One copy of the optimal model per worker, made before any task runs
+    std::vector<std::unique_ptr<ClpSimplex>> workerModels;
+    for (unsigned worker = 0; worker < pool.size(); ++worker) {
+        workerModels.push_back(std::make_unique<ClpSimplex>(model));
+        workerModels.back()->setLogLevel(0);
+    }
+
+    pool.parallelFor(perturbations.size(), [&](size_t i) {
+        ClpSimplex& local = *workerModels[ThreadPool::currentWorker()];
+        const Perturbation& perturbation = perturbations[i];
+        double scale = 1.0 + perturbation.delta / 100.0;
+
+        // Every perturbation starts from the base optimal basis
+        local.copyinStatus(baseStatus.data());
+        std::copy(baseColumnSolution.begin(), baseColumnSolution.end(), local.primalColumnSolution());
+        std::copy(baseRowSolution.begin(), baseRowSolution.end(), local.primalRowSolution());
+
+        if (perturbation.kind == Perturbation::ProductProfit) {
+            // A cost change keeps the basis primal feasible: primal simplex
+            int column = static_cast<int>(perturbation.column);
+            local.setObjectiveCoefficient(column, blendedObjective[column] +
+                                                  profitWeight * objectiveCoefficients[column] * (scale - 1.0));
+            runLpAlgorithm(local, options.algorithm, WarmStart::Other, false);
+            local.setObjectiveCoefficient(column, blendedObjective[column]);
+        } else {
+            // A bound change keeps the basis dual feasible: dual simplex
+            int row = perturbation.kind == Perturbation::GlobalBudget ? globalBudgetRow : globalManHoursRow;
+            local.setRowBounds(row, rowLower[row] * scale, rowUpper[row] * scale);
+            runLpAlgorithm(local, options.algorithm, WarmStart::Bounds, false);
+            local.setRowBounds(row, rowLower[row], rowUpper[row]);
+        }
+
+        SolveResult& result = results[i];
+        result.status = local.status();
+        result.iterations = local.numberIterations();
+        result.objectiveValue = local.objectiveValue();
+
+        const double* solution = local.getColSolution();
+        for (int column = 0; column < numColumns; ++column) {
+            double profitScale = (perturbation.kind == Perturbation::ProductProfit &&
+                                  static_cast<size_t>(column) == perturbation.column) ? scale : 1.0;
+            result.totalProfit += solution[column] * objectiveCoefficients[column] * profitScale;
+            result.totalBudgetUsed += solution[column] * avgCosts[column];
+            result.totalManHoursUsed += solution[column] * avgManHours[column];
+        }
+    });
+    return results;
+}
+
+SensitivityReport Solver::buildSensitivityReport() {
+    ensureModelLoaded();
+    auto start = std::chrono::steady_clock::now();
+    const double infinity = std::numeric_limits<double>::infinity();
+    // Clp treats anything beyond 1e27 as an infinite bound
+    auto clean = [infinity](double value) {
+        return value >= 1e27 ? infinity : (value <= -1e27 ? -infinity : value);
+    };
+
+    int numRows = model.numberRows();
+    int numColumns = model.numberColumns();
+    const double* rowActivity = model.primalRowSolution();
+    const double* rowDuals = model.dualRowSolution();
+    const double* columnValues = model.primalColumnSolution();
+    const double* reducedCosts = model.dualColumnSolution();
+    const double* costs = model.objective();
+
+    // Objective ranging for every column
+    std::vector<int> columns(numColumns);
+    std::iota(columns.begin(), columns.end(), 0);
+    std::vector<double> costIncrease(numColumns), costDecrease(numColumns);
+    std::vector<int> costIncreaseSequence(numColumns), costDecreaseSequence(numColumns);
+    if (numColumns > 0) {
+        model.dualRanging(numColumns, columns.data(), costIncrease.data(), costIncreaseSequence.data(),
+                          costDecrease.data(), costDecreaseSequence.data());
+    }
+
+    // RHS ranging only makes sense for binding rows, whose slack is nonbasic.
+    // Row activities are the slack variables numColumns + row in Clp.
+    std::vector<int> bindingSlacks;
+    std::vector<int> bindingRows;
+    for (int row = 0; row < numRows; ++row) {
+        if (model.getRowStatus(row) != ClpSimplex::basic) {
+            bindingSlacks.push_back(numColumns + row);
+            bindingRows.push_back(row);
+        }
+    }
+    std::vector<double> rhsIncrease(bindingSlacks.size()), rhsDecrease(bindingSlacks.size());
+    std::vector<int> rhsIncreaseSequence(bindingSlacks.size()), rhsDecreaseSequence(bindingSlacks.size());
+    if (!bindingSlacks.empty()) {
+        model.primalRanging(static_cast<int>(bindingSlacks.size()), bindingSlacks.data(),
+                            rhsIncrease.data(), rhsIncreaseSequence.data(),
+                            rhsDecrease.data(), rhsDecreaseSequence.data());
+    }
+
+    SensitivityReport report;
+    report.objectiveValue = model.objectiveValue();
+
+    report.rows.resize(numRows);
+    for (int row = 0; row < numRows; ++row) {
+        RowSensitivity& entry = report.rows[row];
+        if (row == globalBudgetRow) {
+            entry.name = "global_budget";
+        } else if (row == globalManHoursRow) {
+            entry.name = "global_man_hours";
+        } else if (row > globalManHoursRow) {
+            entry.name = lockRowNames[row - globalManHoursRow - 1];
+        } else {
+            entry.name = (row % 2 == 0 ? "budget:" : "man_hours:") + products.name(row / 2);
+        }
+        entry.activity = rowActivity[row];
+        entry.lower = clean(rowLower[row]);
+        entry.upper = clean(rowUpper[row]);
+        entry.dual = rowDuals[row];
+        entry.binding = "none";
+        entry.rhsLow = -infinity;
+        entry.rhsHigh = infinity;
+    }
+    for (size_t i = 0; i < bindingRows.size(); ++i) {
+        RowSensitivity& entry = report.rows[bindingRows[i]];
+        double toUpper = std::fabs(entry.activity - entry.upper);
+        double toLower = std::fabs(entry.activity - entry.lower);
+        entry.binding = toUpper <= toLower ? "upper" : "lower";
+        entry.rhsLow = entry.activity - clean(rhsDecrease[i]);
+        entry.rhsHigh = entry.activity + clean(rhsIncrease[i]);
+    }
+
+    report.columns.resize(numColumns);
+    for (int column = 0; column < numColumns; ++column) {
+        ColumnSensitivity& entry = report.columns[column];
+        entry.name = products.name(column);
+        entry.value = columnValues[column];
+        entry.lower = clean(lowerBounds[column]);
+        entry.upper = clean(upperBounds[column]);
+        entry.reducedCost = reducedCosts[column];
+        entry.basic = model.getColumnStatus(column) == ClpSimplex::basic;
+        entry.cost = costs[column];
+        entry.costLow = entry.cost - clean(costDecrease[column]);
+        entry.costHigh = entry.cost + clean(costIncrease[column]);
+    }
+
+    report.rangingMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+ParametricCurve Solver::traceParametric() {
+    ensureModelLoaded();
+    const ParametricSweep& sweep = options.parametric;
+    ParametricTarget target;
+    target.name = sweep.target;
+
+    auto objectiveTarget = [&](double baseTheta, const std::vector<double>& direction) {
+        target.kind = ParametricTarget::Objective;
+        target.baseCosts = blendedObjective;
+        target.direction = direction;
+        target.baseTheta = baseTheta;
+    };
+
+    if (sweep.target == "global_budget") {
+        target.row = globalBudgetRow;
+    } else if (sweep.target == "global_man_hours") {
+        target.row = globalManHoursRow;
+    } else if (sweep.target.rfind("row:", 0) == 0) {
+        target.row = std::stoi(sweep.target.substr(4));
+        if (target.row < 0 || target.row >= model.numberRows()) {
+            throw std::invalid_argument("Parametric row out of range: " + sweep.target);
+        }
+    } else if (sweep.target == "profit_weight") {
+        objectiveTarget(profitWeight, objectiveCoefficients);
+    } else if (sweep.target == "resource_weight") {
+        std::vector<double> direction(avgManHours.size());
+        std::transform(avgManHours.begin(), avgManHours.end(), direction.begin(), [](double value) { return -value; });
+        objectiveTarget(resourceWeight, direction);
+    } else if (sweep.target == "budget_weight") {
+        objectiveTarget(budgetWeight, avgCosts);
+    } else {
+        throw std::invalid_argument("Unknown parametric target: " + sweep.target);
+    }
+
+    // Sweep a copy so the reported solution stays untouched
+    ClpSimplex local(model);
+    local.setLogLevel(0);
+    return traceParametricCurve(local, target, sweep.from, sweep.to, options.algorithm);
+}
+
+void Solver::displayParametricCurve(const ParametricCurve& curve) const {
+    std::cout << "\nParametric curve for " << curve.target << " (" << curve.breakpoints.size() << " breakpoints, "
+              << curve.solves << " warm re-solves, " << curve.iterations << " iterations):\n";
+    std::cout << std::setw(20) << "Theta" << std::setw(20) << "Objective" << "\n";
+    for (const auto& point : curve.breakpoints) {
+        std::cout << std::setw(20) << point.theta << std::setw(20) << point.value << "\n";
+    }
+}
+
+MonteCarloReport Solver::runMonteCarlo() {
+    const MonteCarloConfig& config = options.monteCarlo;
+    const double* solution = columnSolution();
+    PlanColumns plan;
+    plan.count = products.size();
+    plan.units = solution;
+    plan.costMin = products.column(&Product::costMin).data();
+    plan.costMax = products.column(&Product::costMax).data();
+    plan.profitMin = products.column(&Product::profitMin).data();
+    plan.profitMax = products.column(&Product::profitMax).data();
+    plan.manHourPerUnitMin = products.column(&Product::manHourPerUnitMin).data();
+    plan.manHourPerUnitMax = products.column(&Product::manHourPerUnitMax).data();
+    plan.budgetMin = products.column(&Product::budgetMin).data();
+    plan.budgetMax = products.column(&Product::budgetMax).data();
+    plan.totalManHoursMax = products.column(&Product::totalManHoursMax).data();
+
+    auto start = std::chrono::steady_clock::now();
+    SampleOutcomes outcomes = evaluatePlanSamples(plan, globalConstraints, config.seed, config.samples, options.threads);
+    MonteCarloReport report = summarizeSamples(outcomes, globalConstraints);
+    report.seed = config.seed;
+    report.evaluateMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (config.resolveSamples > 0) {
+        ensureModelLoaded();
+        // Loading may have replaced the structured solution the plan points at
+        plan.units = columnSolution();
+        resolveSamples(plan, outcomes, report);
+    }
+    return report;
+}
+
+void Solver::resolveSamples(const PlanColumns& plan, const SampleOutcomes& outcomes, MonteCarloReport& report) {
+    size_t count = std::min(options.monteCarlo.resolveSamples, outcomes.profit.size());
+    size_t numProducts = products.size();
+    int numRows = model.numberRows();
+    int numColumns = model.numberColumns();
+    std::vector<unsigned char> baseStatus(model.statusArray(), model.statusArray() + numRows + numColumns);
+    std::vector<double> baseColumnSolution(model.primalColumnSolution(), model.primalColumnSolution() + numColumns);
+    std::vector<double> baseRowSolution(model.primalRowSolution(), model.primalRowSolution() + numRows);
+
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(options.threads);
+
+    // One copy of the midpoint model per worker; every sample rewrites all
+    // costs and coefficients, so nothing needs restoring between samples
+    std::vector<std::unique_ptr<ClpSimplex>> workerModels;
+    for (unsigned worker = 0; worker < pool.size(); ++worker) {
+        workerModels.push_back(std::make_unique<ClpSimplex>(model));
+        workerModels.back()->setLogLevel(0);
+    }
+
+    std::vector<int> status(count);
+    std::vector<int> iterations(count);
+    std::vector<double> resolvedProfit(count);
+    pool.parallelFor(count, [&](size_t sample) {
+        ClpSimplex& local = *workerModels[ThreadPool::currentWorker()];
+        std::vector<double> cost(numProducts), profitPercent(numProducts), manHourPerUnit(numProducts);
+        drawSample(plan, options.monteCarlo.seed, sample, cost.data(), profitPercent.data(), manHourPerUnit.data());
+
+        local.copyinStatus(baseStatus.data());
+        std::copy(baseColumnSolution.begin(), baseColumnSolution.end(), local.primalColumnSolution());
+        std::copy(baseRowSolution.begin(), baseRowSolution.end(), local.primalRowSolution());
+        for (size_t i = 0; i < numProducts; ++i) {
+            int column = static_cast<int>(i);
+            local.setObjectiveCoefficient(column, profitWeight * cost[i] * profitPercent[i] / 100.0 -
+                                                  resourceWeight * manHourPerUnit[i] + budgetWeight * cost[i]);
+            local.modifyCoefficient(2 * column, column, cost[i]);
+            local.modifyCoefficient(2 * column + 1, column, manHourPerUnit[i]);
+            local.modifyCoefficient(globalBudgetRow, column, cost[i]);
+            local.modifyCoefficient(globalManHoursRow, column, manHourPerUnit[i]);
+        }
+        runLpAlgorithm(local, options.algorithm, WarmStart::Other, false);
+
+        status[sample] = local.status();
+        iterations[sample] = local.numberIterations();
+        const double* solution = local.getColSolution();
+        double profit = 0.0;
+        for (size_t i = 0; i < numProducts; ++i) {
+            profit += solution[i] * cost[i] * profitPercent[i] / 100.0;
+        }
+        resolvedProfit[sample] = profit;
+    });
+
+    std::vector<double> optimalProfit, profitGap;
+    for (size_t sample = 0; sample < count; ++sample) {
+        report.resolveIterations += iterations[sample];
+        if (status[sample] != 0) continue;
+        optimalProfit.push_back(resolvedProfit[sample]);
+        profitGap.push_back(resolvedProfit[sample] - outcomes.profit[sample]);
+    }
+    report.resolved = count;
+    report.resolvedOptimal = optimalProfit.size();
+    report.resolvedProfit = summarizeDistribution(std::move(optimalProfit));
+    report.profitGap = summarizeDistribution(std::move(profitGap));
+    report.resolveMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Solver::displayMonteCarlo(const MonteCarloReport& report) const {
+    std::cout << "\nMonte Carlo evaluation over " << report.samples << " samples (seed " << report.seed << ", "
+              << monteCarloKernelIsa() << " kernel, " << report.evaluateMillis << " ms):\n";
+    std::cout << std::setw(20) << "" << std::setw(14) << "Mean" << std::setw(14) << "Stddev" << std::setw(14) << "P5"
+              << std::setw(14) << "P50" << std::setw(14) << "P95" << "\n";
+    auto row = [](const char* name, const Distribution& d) {
+        std::cout << std::setw(20) << name << std::setw(14) << d.mean << std::setw(14) << d.stddev << std::setw(14)
+                  << d.p5 << std::setw(14) << d.p50 << std::setw(14) << d.p95 << "\n";
+    };
+    row("Profit", report.profit);
+    row("Budget Used", report.budget);
+    row("Man Hours", report.manHours);
+    row("Budget Violation", report.budgetViolation);
+    row("Man-Hour Violation", report.manHoursViolation);
+    std::cout << "Samples violating a constraint: " << report.violatedShare * 100.0 << "% (global budget "
+              << report.globalBudgetViolatedShare * 100.0 << "%, global man-hours "
+              << report.globalManHoursViolatedShare * 100.0 << "%)\n";
+    if (report.resolved > 0) {
+        std::cout << "Re-optimized " << report.resolved << " samples from the midpoint basis in " << report.resolveMillis
+                  << " ms, " << report.resolvedOptimal << " optimal, " << report.resolveIterations
+                  << " simplex iterations in total.\n";
+        row("Re-optimized Profit", report.resolvedProfit);
+        row("Profit Gap", report.profitGap);
+    }
+}
@@ -2,29 +2,143 @@
 #ifndef SOLVER_H
 #define SOLVER_H
 
+#include "branch_and_bound.h"
 #include "input.h"
-#include <unordered_map>
+#include "lp_algorithm.h"
+#include "monte_carlo.h"
+#include "parametric.h"
+#include "result_writer.h"
+#include "sensitivity_report.h"
+#include "solution_cache.h"
+#include "structured_solver.h"
 #include <vector>
 #include <ClpSimplex.hpp>
 
+// How the main solve is carried out
+enum class SolverEngine {
+    Auto,  // Structured fast path when the model has its usual shape, Clp otherwise
+    Clp    // Always Clp, with the configured algorithm
+};
+
+// Solver run configuration
+struct SolverOptions {
+    bool verbose = true;            // Print results, validation and sensitivity analysis
+    SolverEngine engine = SolverEngine::Auto;
+    LpAlgorithm algorithm = LpAlgorithm::Auto;  // Clp algorithm when the fast path does not apply
+    bool presolve = false;          // Clp presolve on cold solves
+    bool lexicographic = false;     // Optimize ranks in turn instead of blending them by 1/rank
+    double lexicographicTolerance = 1e-6;  // Relative slack on each locked optimum
+    bool integerUnits = false;      // Whole units per product by branch-and-bound over the LP
+    double integerGap = 1e-4;       // Relative gap at which the integer search stops
+    size_t integerMaxNodes = 100000;
+    unsigned threads = 0;           // Worker threads for parallel phases, 0 = all cores
+    SensitivityConfig sensitivity;  // Perturbation grids re-solved after the main solve
+    std::string sensitivityReportFile;  // Write duals, reduced costs and ranging as JSON
+    ParametricSweep parametric;     // Optional value curve over one row bound or objective weight
+    MonteCarloConfig monteCarlo;    // Sampled realizations of the product ranges evaluated against the plan
+    std::string resultsFile;        // Per-product solution rows, "-" for stdout
+    std::string sensitivityResultsFile;  // One row per sensitivity perturbation
+    ResultFormat resultsFormat = ResultFormat::Csv;
+    bool backgroundWriter = false;  // Write result blocks from a second thread
+    size_t topK = 20;               // Rows in the printed tables, 0 = all
+    // Solution and basis cache, empty = off. A near hit's basis only warm starts
+    // Clp, so it matters with --engine clp or models the fast path does not take.
+    std::string cacheDir;
+    uint64_t cacheMaxBytes = 256ull << 20;
+};
+
+// Wall time of each solve() phase in milliseconds
+struct SolvePhaseTimes {
+    double setupModel = 0.0;
+    double applyConstraints = 0.0;
+    double defineObjective = 0.0;
+    double solve = 0.0;   // Structured fast path and/or Clp, including loadProblem
+    double report = 0.0;  // Totals, plus the results table and checks when verbose
+};
+
+// Summary of a finished solve
+struct SolveResult {
+    int status = -1;          // Clp status, 0 = optimal
+    int iterations = 0;
+    double objectiveValue = 0.0;
+    double totalProfit = 0.0;
+    double totalBudgetUsed = 0.0;
+    double totalManHoursUsed = 0.0;
+    SolvePhaseTimes phases;
+    CacheLookup cache = CacheLookup::Off;
+    LpAlgorithm algorithm = LpAlgorithm::Auto;  // Clp algorithm that ran, Auto when Clp did not
+    size_t lexicographicStages = 0;  // Ranks optimized in turn, 0 for the blended objective
+    size_t integerNodes = 0;  // Branch-and-bound nodes solved, 0 without integer units
+    double integerBound = 0.0;  // Lowest objective any whole-unit plan can reach
+};
+
+// One perturbation of the sensitivity sweep, delta in percent
+struct Perturbation {
+    enum Kind { ProductProfit, GlobalBudget, GlobalManHours };
+    Kind kind;
+    size_t column;  // Product column for ProductProfit
+    double delta;
+};
+
+// Human readable name for a Clp status code
+const char* solveStatusName(int status);
+
+// Weights of the blended objective, 1/rank of maximize_profit,
+// minimize_resource_usage and maximize_budget_usage, 0 when absent
+struct ObjectiveWeights {
+    double profit = 0.0;
+    double resource = 0.0;
+    double budget = 0.0;
+};
+ObjectiveWeights blendWeights(const std::vector<Objective>& objectives);
+
 // Function declarations for solver
 class Solver {
 public:
-    Solver(const std::unordered_map<std::string, Product>& products,
+    Solver(const ProductTable& products,
            const GlobalConstraints& globalConstraints,
-           const std::vector<Objective>& objectives);
+           const std::vector<Objective>& objectives,
+           const SolverOptions& options = SolverOptions());
 
     // Run the solver
-    void solve();
+    SolveResult solve();
+
+    // Assemble the LP and load it into Clp without solving
+    void buildModel();
+
+    // Assemble the LP arrays only, read through lpView()
+    void assembleModel();
+    LpView lpView() const;
+
+    // Duals, reduced costs and ranging from the final optimal basis
+    SensitivityReport buildSensitivityReport();
+
+    // Exact optimal value curve for options.parametric, from the optimal basis
+    ParametricCurve traceParametric();
+
+    // Evaluate the optimal plan under options.monteCarlo.samples draws from
+    // the product ranges, re-optimizing the first resolveSamples of them
+    MonteCarloReport runMonteCarlo();
+
+    // Current value of one column, column i is product i of the table
+    double columnValue(size_t column) const;
+
+    // Push edits of the referenced inputs into the loaded model in place.
+    // Nothing is rebuilt; resolve() re-optimizes from the current basis.
+    void updateProduct(size_t column);
+    void updateGlobalConstraints();
+    void updateObjectives();
+    SolveResult resolve();
 
 private:
     // Internal data
-    const std::unordered_map<std::string, Product>& products;
+    const ProductTable& products;
     const GlobalConstraints& globalConstraints;
     const std::vector<Objective>& objectives;
+    SolverOptions options;
     ClpSimplex model;
 
-    // Decision variables
+    // Decision variables, in product table order
     std::vector<double> objectiveCoefficients;
     std::vector<double> lowerBounds;
     std::vector<double> upperBounds;
@@ -33,13 +147,70 @@ private:
     std::vector<double> avgCosts;
     std::vector<double> avgManHours;
 
+    // Blended objective and column-major constraint matrix handed to Clp
+    std::vector<double> blendedObjective;
+    std::vector<CoinBigIndex> columnStarts;
+    std::vector<int> rowIndices;
+    std::vector<double> elements;
+    std::vector<double> rowLower;
+    std::vector<double> rowUpper;
+    // Result of the structured fast path; Clp is only loaded when a basis is needed
+    StructuredSolution structured;
+    bool modelLoaded = false;
+    // Basis of a cached solve of the same catalog, used when the fast path is not
+    CachedSolution cachedStart;
+    bool warmStartFromCache = false;
+    LpAlgorithm lastAlgorithm = LpAlgorithm::Auto;
+    // Rows locking earlier lexicographic optima, after the global rows
+    std::vector<std::string> lockRowNames;
+
+    // One rank of a lexicographic solve, weights as in blendedCoefficient
+    struct LexicographicStage {
+        int rank = 0;
+        double profitWeight = 0.0;
+        double resourceWeight = 0.0;
+        double budgetWeight = 0.0;
+        std::string label;
+    };
+
+    int globalBudgetRow = 0;
+    int globalManHoursRow = 0;
+    double profitWeight = 0.0;
+    double resourceWeight = 0.0;
+    double budgetWeight = 0.0;
+
+    // Kinds of in-place edits since the last solve, picks the warm-start algorithm
+    enum : unsigned { BoundEdit = 1, ObjectiveEdit = 2, MatrixEdit = 4 };
+    unsigned pendingEdits = 0;
+
     // Helper methods
     void setupModel();
+    void loadModel();
+    void ensureModelLoaded();
+    const double* columnSolution() const;
+    void lookupCache(SolutionCache& cache, const CacheKey& key, SolveResult& result);
+    CachedSolution currentSolution() const;
     void applyConstraints();
     void defineObjectiveFunction();
+    std::vector<LexicographicStage> lexicographicStages() const;
+    void useStageWeights(const LexicographicStage& stage);
+    void solveLexicographic(SolveResult& result);
+    void solveWholeUnits(SolveResult& result);
+    double blendedCoefficient(size_t column) const {
+        return profitWeight * objectiveCoefficients[column] - resourceWeight * avgManHours[column] +
+               budgetWeight * avgCosts[column];
+    }
     void displayResults();
+    void writeSolutionResults() const;
     void validateSolution();
+    void computeTotals(SolveResult& result) const;
+    void displayParametricCurve(const ParametricCurve& curve) const;
+    void displayMonteCarlo(const MonteCarloReport& report) const;
+    void resolveSamples(const PlanColumns& plan, const SampleOutcomes& outcomes, MonteCarloReport& report);
     void performSensitivityAnalysis();
+    void writeSensitivityResults(const std::vector<Perturbation>& perturbations,
+                                 const std::vector<SolveResult>& results) const;
+    std::vector<SolveResult> resolvePerturbations(const std::vector<Perturbation>& perturbations);
 };
 
 #endif // SOLVER_H
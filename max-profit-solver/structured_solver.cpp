@@ -0,0 +1,318 @@
+#include "structured_solver.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double kInfinity = 1e27;   // Clp treats larger bounds as infinite
+const double kTolerance = 1e-9;
+const int kMaxSearchSteps = 200;
+
+// Box after folding the singleton rows, plus up to two coupling rows
+struct FoldedProblem {
+    std::vector<double> lower, upper;
+    std::vector<int> lowerRow, upperRow;  // Singleton row that set the bound, -1 = column bound
+    std::vector<double> a, h;             // Dense coupling rows, empty when absent
+    double aLower = -kInfinity, aUpper = kInfinity;
+    double hLower = -kInfinity, hUpper = kInfinity;
+};
+
+struct Candidate {
+    double ratio;   // Objective change per unit of coupling row activity
+    double weight;  // Row activity change when moved to the other bound
+    int column;
+};
+
+bool near(double value, double target) {
+    return std::abs(value - target) <= kTolerance * (1.0 + std::abs(target));
+}
+
+// min d.x over the box subject to aLower <= a.x <= aUpper. Every column
+// starts at its cheaper bound; if the row is violated the cheapest moves
+// per unit of row activity are taken until it holds, the last one
+// partially. The cut-off is found by a weighted quickselect, O(n) expected.
+bool solveKnapsack(const FoldedProblem& p, const std::vector<double>& d,
+                   std::vector<double>& x, std::vector<Candidate>& candidates) {
+    size_t n = d.size();
+    double activity = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = d[i] < 0.0 ? p.upper[i] : p.lower[i];
+    }
+    if (p.a.empty()) {
+        return true;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        activity += p.a[i] * x[i];
+    }
+
+    double need = 0.0;
+    double direction = 0.0;
+    if (activity > p.aUpper) {
+        need = activity - p.aUpper;
+        direction = -1.0;
+    } else if (activity < p.aLower) {
+        need = p.aLower - activity;
+        direction = 1.0;
+    } else {
+        return true;
+    }
+
+    candidates.clear();
+    for (size_t i = 0; i < n; ++i) {
+        double other = d[i] < 0.0 ? p.lower[i] : p.upper[i];
+        double change = p.a[i] * (other - x[i]);
+        if (change * direction > 0.0) {
+            candidates.push_back({std::abs(d[i]) / std::abs(p.a[i]), std::abs(change), static_cast<int>(i)});
+        }
+    }
+
+    auto byRatio = [](const Candidate& left, const Candidate& right) { return left.ratio < right.ratio; };
+    size_t first = 0;
+    size_t last = candidates.size();
+    while (last - first > 1) {
+        size_t mid = first + (last - first) / 2;
+        std::nth_element(candidates.begin() + first, candidates.begin() + mid, candidates.begin() + last, byRatio);
+        double left = 0.0;
+        for (size_t k = first; k < mid; ++k) {
+            left += candidates[k].weight;
+        }
+        if (left >= need) {
+            last = mid;
+        } else {
+            need -= left;
+            first = mid;
+        }
+    }
+
+    // Candidates before first move all the way, candidate first covers the rest
+    if (first == candidates.size() || need > candidates[first].weight * (1.0 + kTolerance)) {
+        return false;
+    }
+    for (size_t k = 0; k < first; ++k) {
+        int i = candidates[k].column;
+        x[i] = d[i] < 0.0 ? p.lower[i] : p.upper[i];
+    }
+    int i = candidates[first].column;
+    double other = d[i] < 0.0 ? p.lower[i] : p.upper[i];
+    x[i] += (other - x[i]) * std::min(1.0, need / candidates[first].weight);
+    return true;
+}
+
+} // namespace
+
+StructuredSolution solveStructured(const LpView& lp) {
+    StructuredSolution solution;
+    size_t n = static_cast<size_t>(lp.numColumns);
+    size_t m = static_cast<size_t>(lp.numRows);
+
+    // Rows with more than one nonzero couple columns, at most two are allowed
+    std::vector<int> rowCount(m, 0);
+    for (CoinBigIndex k = 0; k < lp.columnStarts[n]; ++k) {
+        if (lp.elements[k] != 0.0) ++rowCount[lp.rowIndices[k]];
+    }
+    std::vector<int> coupling;
+    for (size_t r = 0; r < m; ++r) {
+        if (rowCount[r] > 1) coupling.push_back(static_cast<int>(r));
+        bool emptyRange = lp.rowLower[r] > lp.rowUpper[r] && !near(lp.rowLower[r], lp.rowUpper[r]);
+        if (emptyRange || (rowCount[r] == 0 && (lp.rowLower[r] > kTolerance || lp.rowUpper[r] < -kTolerance))) {
+            solution.outcome = StructuredSolution::Infeasible;
+            return solution;
+        }
+    }
+    if (coupling.size() > 2) {
+        return solution;
+    }
+
+    FoldedProblem p;
+    p.lower.assign(lp.columnLower, lp.columnLower + n);
+    p.upper.assign(lp.columnUpper, lp.columnUpper + n);
+    p.lowerRow.assign(n, -1);
+    p.upperRow.assign(n, -1);
+    if (coupling.size() > 0) {
+        p.a.assign(n, 0.0);
+        p.aLower = lp.rowLower[coupling[0]];
+        p.aUpper = lp.rowUpper[coupling[0]];
+    }
+    if (coupling.size() > 1) {
+        p.h.assign(n, 0.0);
+        p.hLower = lp.rowLower[coupling[1]];
+        p.hUpper = lp.rowUpper[coupling[1]];
+    }
+
+    for (size_t j = 0; j < n; ++j) {
+        for (CoinBigIndex k = lp.columnStarts[j]; k < lp.columnStarts[j + 1]; ++k) {
+            int row = lp.rowIndices[k];
+            double element = lp.elements[k];
+            if (element == 0.0) continue;
+            if (!coupling.empty() && row == coupling[0]) {
+                p.a[j] = element;
+                continue;
+            }
+            if (coupling.size() > 1 && row == coupling[1]) {
+                p.h[j] = element;
+                continue;
+            }
+
+            // Singleton row: rowLower <= element * x <= rowUpper
+            double low = element > 0.0 ? lp.rowLower[row] : lp.rowUpper[row];
+            double high = element > 0.0 ? lp.rowUpper[row] : lp.rowLower[row];
+            if (std::abs(low) < kInfinity && low / element > p.lower[j]) {
+                p.lower[j] = low / element;
+                p.lowerRow[j] = row;
+            }
+            if (std::abs(high) < kInfinity && high / element < p.upper[j]) {
+                p.upper[j] = high / element;
+                p.upperRow[j] = row;
+            }
+        }
+
+        if (p.lower[j] <= -kInfinity || p.upper[j] >= kInfinity) {
+            return solution;
+        }
+        if (p.lower[j] > p.upper[j]) {
+            if (!near(p.lower[j], p.upper[j])) {
+                solution.outcome = StructuredSolution::Infeasible;
+                return solution;
+            }
+            p.lower[j] = p.upper[j];
+        }
+    }
+
+    const double* c = lp.objective;
+    std::vector<double> x(n), d(c, c + n);
+    std::vector<Candidate> candidates;
+    if (!solveKnapsack(p, d, x, candidates)) {
+        solution.outcome = StructuredSolution::Infeasible;
+        return solution;
+    }
+    solution.evaluations = 1;
+
+    if (!p.h.empty()) {
+        double activity = 0.0;
+        for (size_t i = 0; i < n; ++i) activity += p.h[i] * x[i];
+
+        if ((activity > p.hUpper && !near(activity, p.hUpper)) ||
+            (activity < p.hLower && !near(activity, p.hLower))) {
+            // Price the second coupling row: q(nu) = min (c + sigma nu h).x - sigma nu target
+            // is concave and piecewise linear with slope sigma (h.x - target).
+            double sigma = activity > p.hUpper ? 1.0 : -1.0;
+            double target = sigma > 0.0 ? p.hUpper : p.hLower;
+
+            struct Point {
+                double nu, q, slope, activity;
+                std::vector<double> x;
+            };
+            auto evaluate = [&](double nu, Point& point) {
+                for (size_t i = 0; i < n; ++i) {
+                    d[i] = c[i] + sigma * nu * p.h[i];
+                }
+                point.x.resize(n);
+                if (!solveKnapsack(p, d, point.x, candidates)) return false;
+                ++solution.evaluations;
+                double lagrangian = 0.0;
+                point.activity = 0.0;
+                for (size_t i = 0; i < n; ++i) {
+                    lagrangian += d[i] * point.x[i];
+                    point.activity += p.h[i] * point.x[i];
+                }
+                point.nu = nu;
+                point.q = lagrangian - sigma * nu * target;
+                point.slope = sigma * (point.activity - target);
+                return true;
+            };
+
+            Point lo{0.0, 0.0, 0.0, activity, x};
+            double objective = 0.0;
+            for (size_t i = 0; i < n; ++i) objective += c[i] * x[i];
+            lo.q = objective;
+            lo.slope = sigma * (activity - target);
+
+            // Double the multiplier from the cost/coefficient scale until the row holds
+            double maxCost = 0.0, maxCoefficient = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                maxCost = std::max(maxCost, std::abs(c[i]));
+                maxCoefficient = std::max(maxCoefficient, std::abs(p.h[i]));
+            }
+            double nu = maxCoefficient > 0.0 && maxCost > 0.0 ? maxCost / maxCoefficient : 1.0;
+            Point hi, mid;
+            int steps = 0;
+            for (; steps < kMaxSearchSteps; ++steps, nu *= 2.0) {
+                if (!evaluate(nu, hi)) return solution;
+                if (hi.slope <= 0.0) break;
+                std::swap(lo, hi);
+            }
+            if (steps == kMaxSearchSteps) {
+                solution.outcome = StructuredSolution::Infeasible;
+                return solution;
+            }
+
+            // Intersect the tangents at both ends until the intersection lies
+            // on q itself: both end solutions are then optimal at that multiplier
+            bool converged = hi.slope == 0.0;
+            for (steps = 0; !converged && steps < kMaxSearchSteps; ++steps) {
+                double next = (hi.q - lo.q + lo.slope * lo.nu - hi.slope * hi.nu) / (lo.slope - hi.slope);
+                if (!(next > lo.nu && next < hi.nu)) {
+                    converged = true;
+                    break;
+                }
+                if (!evaluate(next, mid)) return solution;
+                double tangent = lo.q + lo.slope * (next - lo.nu);
+                if (mid.q >= tangent - kTolerance * (1.0 + std::abs(tangent))) {
+                    converged = true;
+                } else if (mid.slope > 0.0) {
+                    std::swap(lo, mid);
+                } else {
+                    std::swap(hi, mid);
+                    converged = hi.slope == 0.0;
+                }
+            }
+            if (!converged) {
+                return solution;
+            }
+
+            // Mix the two end solutions so the second row is met exactly
+            double theta = hi.slope == 0.0 ? 0.0 : (target - hi.activity) / (lo.activity - hi.activity);
+            for (size_t i = 0; i < n; ++i) {
+                x[i] = theta * lo.x[i] + (1.0 - theta) * hi.x[i];
+            }
+        }
+    }
+
+    solution.outcome = StructuredSolution::Optimal;
+    solution.rowActivities.assign(m, 0.0);
+    for (size_t j = 0; j < n; ++j) {
+        solution.objectiveValue += c[j] * x[j];
+        for (CoinBigIndex k = lp.columnStarts[j]; k < lp.columnStarts[j + 1]; ++k) {
+            solution.rowActivities[lp.rowIndices[k]] += lp.elements[k] * x[j];
+        }
+    }
+
+    // Columns at a bound set by their singleton row leave that row nonbasic
+    // instead; binding coupling rows are nonbasic as well
+    solution.columnStatus.assign(n, BasisStatus::Basic);
+    solution.rowStatus.assign(m, BasisStatus::Basic);
+    std::vector<char> tightRows(m, 0);
+    for (int row : coupling) tightRows[row] = 1;
+    for (size_t j = 0; j < n; ++j) {
+        int row = -2;
+        if (near(x[j], p.lower[j])) {
+            row = p.lowerRow[j];
+            if (row < 0) solution.columnStatus[j] = BasisStatus::AtLower;
+        } else if (near(x[j], p.upper[j])) {
+            row = p.upperRow[j];
+            if (row < 0) solution.columnStatus[j] = BasisStatus::AtUpper;
+        }
+        if (row >= 0) tightRows[row] = 1;
+    }
+    for (size_t r = 0; r < m; ++r) {
+        if (!tightRows[r]) continue;
+        if (near(solution.rowActivities[r], lp.rowUpper[r])) {
+            solution.rowStatus[r] = BasisStatus::AtUpper;
+        } else if (near(solution.rowActivities[r], lp.rowLower[r])) {
+            solution.rowStatus[r] = BasisStatus::AtLower;
+        }
+    }
+
+    solution.columnValues = std::move(x);
+    return solution;
+}
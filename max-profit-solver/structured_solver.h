@@ -0,0 +1,43 @@
+// structured_solver.h
+#ifndef STRUCTURED_SOLVER_H
+#define STRUCTURED_SOLVER_H
+
+#include <vector>
+#include <CoinTypes.hpp>
+
+// Column-major minimization LP, the same arrays handed to ClpSimplex::loadProblem
+struct LpView {
+    int numColumns = 0;
+    int numRows = 0;
+    const CoinBigIndex* columnStarts = nullptr;
+    const int* rowIndices = nullptr;
+    const double* elements = nullptr;
+    const double* columnLower = nullptr;
+    const double* columnUpper = nullptr;
+    const double* objective = nullptr;
+    const double* rowLower = nullptr;
+    const double* rowUpper = nullptr;
+};
+
+// Basis position of a column or row activity, mapped onto ClpSimplex::Status
+enum class BasisStatus : unsigned char { Basic, AtLower, AtUpper };
+
+struct StructuredSolution {
+    enum Outcome { NotApplicable, Optimal, Infeasible };
+    Outcome outcome = NotApplicable;
+    double objectiveValue = 0.0;
+    std::vector<double> columnValues;
+    std::vector<double> rowActivities;
+    std::vector<BasisStatus> columnStatus;  // A basis close to optimal to warm start Clp from
+    std::vector<BasisStatus> rowStatus;
+    int evaluations = 0;                    // Lagrangian subproblems solved
+};
+
+// Solve box-bounded LPs whose rows are single-column rows plus at most two
+// coupling rows without a simplex: singleton rows are folded into column
+// bounds, the first coupling row is handled by a greedy continuous knapsack
+// and the second by a search over its Lagrange multiplier. Any other shape
+// (or an infinite folded bound) returns NotApplicable.
+StructuredSolution solveStructured(const LpView& lp);
+
+#endif // STRUCTURED_SOLVER_H
@@ -0,0 +1,214 @@
+#include "structured_solver.h"
+#include "test_util.h"
+#include <ClpSimplex.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+const double kUnbounded = std::numeric_limits<double>::max();
+
+// Deterministic on every platform, unlike the std distributions
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    double uniform(double lo, double hi) {
+        state += 0x9E3779B97F4A7C15ull;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        return lo + (hi - lo) * static_cast<double>(z >> 11) / 9007199254740992.0;
+    }
+    bool chance(double p) { return uniform(0.0, 1.0) < p; }
+
+private:
+    uint64_t state;
+};
+
+// Box-bounded columns, some with a singleton row, plus up to two coupling
+// rows over every column: the shape solveStructured takes
+struct RandomLp {
+    int numColumns = 0;
+    std::vector<CoinBigIndex> columnStarts;
+    std::vector<int> rowIndices;
+    std::vector<double> elements;
+    std::vector<double> columnLower, columnUpper, objective;
+    std::vector<double> rowLower, rowUpper;
+
+    LpView view() const {
+        LpView lp;
+        lp.numColumns = numColumns;
+        lp.numRows = static_cast<int>(rowLower.size());
+        lp.columnStarts = columnStarts.data();
+        lp.rowIndices = rowIndices.data();
+        lp.elements = elements.data();
+        lp.columnLower = columnLower.data();
+        lp.columnUpper = columnUpper.data();
+        lp.objective = objective.data();
+        lp.rowLower = rowLower.data();
+        lp.rowUpper = rowUpper.data();
+        return lp;
+    }
+};
+
+// Coupling row bounds: a random sub-range of the reachable activity, so
+// the row often cuts the box optimum off; now and then beyond it
+void couplingBounds(Random& random, double minActivity, double maxActivity, double& lower, double& upper) {
+    double span = maxActivity - minActivity;
+    if (random.chance(0.1)) {
+        lower = maxActivity + random.uniform(0.1, 1.0) * (1.0 + span);  // Infeasible
+        upper = kUnbounded;
+        return;
+    }
+    lower = random.chance(0.4) ? -kUnbounded : minActivity + random.uniform(0.0, 0.6) * span;
+    double from = lower == -kUnbounded ? minActivity : lower;
+    upper = random.chance(0.4) ? kUnbounded : from + random.uniform(0.05, 1.0) * (maxActivity - from);
+}
+
+RandomLp randomLp(Random& random, int couplingRows) {
+    RandomLp lp;
+    lp.numColumns = 1 + static_cast<int>(random.uniform(0.0, 10.0));
+    int n = lp.numColumns;
+    std::vector<std::vector<double>> coupling(couplingRows, std::vector<double>(n));
+    std::vector<double> minActivity(couplingRows, 0.0), maxActivity(couplingRows, 0.0);
+
+    lp.columnStarts.push_back(0);
+    for (int j = 0; j < n; ++j) {
+        double lower = random.uniform(-5.0, 10.0);
+        lp.columnLower.push_back(lower);
+        lp.columnUpper.push_back(lower + (random.chance(0.1) ? 0.0 : random.uniform(0.0, 20.0)));
+        lp.objective.push_back(random.chance(0.1) ? 0.0 : random.uniform(-10.0, 10.0));
+
+        // Singleton row narrowing the box, occasionally to nothing
+        if (random.chance(0.5)) {
+            double element = random.uniform(0.5, 3.0) * (random.chance(0.3) ? -1.0 : 1.0);
+            double a = element * lp.columnLower[j], b = element * lp.columnUpper[j];
+            double lo = std::min(a, b), hi = std::max(a, b);
+            double rowLower = lo + random.uniform(-0.2, 0.5) * (hi - lo);
+            double rowUpper = random.chance(0.05) ? rowLower - 1.0 : rowLower + random.uniform(0.0, 1.0) * (hi - rowLower);
+            lp.rowIndices.push_back(static_cast<int>(lp.rowLower.size()));
+            lp.elements.push_back(element);
+            lp.rowLower.push_back(random.chance(0.2) ? -kUnbounded : rowLower);
+            lp.rowUpper.push_back(random.chance(0.2) ? kUnbounded : rowUpper);
+        }
+        lp.columnStarts.push_back(static_cast<CoinBigIndex>(lp.rowIndices.size()));
+
+        for (int k = 0; k < couplingRows; ++k) {
+            double element = random.chance(0.8) ? random.uniform(0.5, 5.0) : random.uniform(-2.0, 0.5);
+            coupling[k][j] = element;
+            minActivity[k] += std::min(element * lp.columnLower[j], element * lp.columnUpper[j]);
+            maxActivity[k] += std::max(element * lp.columnLower[j], element * lp.columnUpper[j]);
+        }
+    }
+
+    // Append the coupling rows to every column, after the singleton rows
+    int firstCoupling = static_cast<int>(lp.rowLower.size());
+    for (int k = 0; k < couplingRows; ++k) {
+        double lower, upper;
+        couplingBounds(random, minActivity[k], maxActivity[k], lower, upper);
+        lp.rowLower.push_back(lower);
+        lp.rowUpper.push_back(upper);
+    }
+    std::vector<CoinBigIndex> starts(1, 0);
+    std::vector<int> indices;
+    std::vector<double> values;
+    for (int j = 0; j < n; ++j) {
+        for (CoinBigIndex e = lp.columnStarts[j]; e < lp.columnStarts[j + 1]; ++e) {
+            indices.push_back(lp.rowIndices[e]);
+            values.push_back(lp.elements[e]);
+        }
+        for (int k = 0; k < couplingRows; ++k) {
+            indices.push_back(firstCoupling + k);
+            values.push_back(coupling[k][j]);
+        }
+        starts.push_back(static_cast<CoinBigIndex>(indices.size()));
+    }
+    lp.columnStarts = std::move(starts);
+    lp.rowIndices = std::move(indices);
+    lp.elements = std::move(values);
+    return lp;
+}
+
+struct Comparison {
+    int optimal = 0, infeasible = 0, searched = 0;
+};
+
+void compareWithClp(const RandomLp& random, Comparison& counts) {
+    LpView lp = random.view();
+    StructuredSolution structured = solveStructured(lp);
+
+    ClpSimplex model;
+    model.setLogLevel(0);
+    model.loadProblem(lp.numColumns, lp.numRows, lp.columnStarts, lp.rowIndices, lp.elements,
+                      lp.columnLower, lp.columnUpper, lp.objective, lp.rowLower, lp.rowUpper);
+    model.dual();
+
+    CHECK(structured.outcome != StructuredSolution::NotApplicable);
+    if (model.status() != 0) {
+        CHECK(model.status() == 1);
+        CHECK(structured.outcome == StructuredSolution::Infeasible);
+        ++counts.infeasible;
+        return;
+    }
+    CHECK(structured.outcome == StructuredSolution::Optimal);
+    CHECK_NEAR(structured.objectiveValue, model.objectiveValue(), 1e-7);
+    ++counts.optimal;
+    if (structured.evaluations > 1) ++counts.searched;
+
+    // The fast path's own plan is feasible
+    const double tolerance = 1e-7;
+    for (int j = 0; j < lp.numColumns; ++j) {
+        double value = structured.columnValues[j];
+        CHECK(value >= lp.columnLower[j] - tolerance * (1.0 + std::fabs(lp.columnLower[j])));
+        CHECK(value <= lp.columnUpper[j] + tolerance * (1.0 + std::fabs(lp.columnUpper[j])));
+    }
+    for (int r = 0; r < lp.numRows; ++r) {
+        double activity = structured.rowActivities[r];
+        CHECK(lp.rowLower[r] == -kUnbounded || activity >= lp.rowLower[r] - tolerance * (1.0 + std::fabs(lp.rowLower[r])));
+        CHECK(lp.rowUpper[r] == kUnbounded || activity <= lp.rowUpper[r] + tolerance * (1.0 + std::fabs(lp.rowUpper[r])));
+    }
+}
+
+} // namespace
+
+TEST_CASE(structuredMatchesClpWithoutCouplingRows) {
+    Random random(1);
+    Comparison counts;
+    for (int model = 0; model < 200; ++model) {
+        compareWithClp(randomLp(random, 0), counts);
+    }
+    CHECK(counts.optimal > 0);
+    CHECK(counts.infeasible > 0);
+}
+
+TEST_CASE(structuredMatchesClpWithOneCouplingRow) {
+    Random random(2);
+    Comparison counts;
+    for (int model = 0; model < 300; ++model) {
+        compareWithClp(randomLp(random, 1), counts);
+    }
+    CHECK(counts.optimal > 0);
+    CHECK(counts.infeasible > 0);
+}
+
+TEST_CASE(structuredMatchesClpWithTwoCouplingRows) {
+    Random random(3);
+    Comparison counts;
+    for (int model = 0; model < 500; ++model) {
+        compareWithClp(randomLp(random, 2), counts);
+    }
+    CHECK(counts.optimal > 0);
+    CHECK(counts.infeasible > 0);
+    CHECK(counts.searched > 0);  // The second row bound, the multiplier search ran
+}
+
+TEST_CASE(structuredRejectsThreeCouplingRows) {
+    Random random(4);
+    RandomLp lp = randomLp(random, 3);
+    while (lp.numColumns < 2) lp = randomLp(random, 3);  // One column makes every row a singleton
+    CHECK(solveStructured(lp.view()).outcome == StructuredSolution::NotApplicable);
+}
@@ -0,0 +1,63 @@
+#include "test_util.h"
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+std::vector<TestCase>& testRegistry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+void checkTrue(bool condition, const char* expression, const char* file, int line) {
+    if (!condition) {
+        throw TestFailure(std::string(file) + ":" + std::to_string(line) + ": CHECK(" + expression + ") failed");
+    }
+}
+
+void checkNear(double actual, double expected, double relativeTolerance, const char* expression,
+               const char* file, int line) {
+    if (!(std::fabs(actual - expected) <= relativeTolerance * (1.0 + std::fabs(expected)))) {
+        std::ostringstream message;
+        message.precision(17);
+        message << file << ":" << line << ": " << expression << " is " << actual << ", expected " << expected;
+        throw TestFailure(message.str());
+    }
+}
+
+static std::filesystem::path scratchDirectory() {
+    static const std::filesystem::path directory = [] {
+        std::filesystem::path path = std::filesystem::temp_directory_path() /
+                                     ("profit_tests_" + std::to_string(getpid()));
+        std::filesystem::create_directories(path);
+        return path;
+    }();
+    return directory;
+}
+
+std::string scratchPath(const std::string& name) {
+    return (scratchDirectory() / name).string();
+}
+
+// Usage: profit_tests [substring], runs every test whose name contains it
+int main(int argc, char* argv[]) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    size_t run = 0, failed = 0;
+    for (const TestCase& test : testRegistry()) {
+        if (std::string(test.name).find(filter) == std::string::npos) continue;
+        ++run;
+        try {
+            test.body();
+            std::cout << "[ ok ] " << test.name << "\n";
+        } catch (const std::exception& ex) {
+            ++failed;
+            std::cout << "[FAIL] " << test.name << ": " << ex.what() << "\n";
+        }
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove_all(scratchDirectory(), ignored);
+    std::cout << run - failed << " of " << run << " tests passed\n";
+    return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+// test_util.h
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Minimal test registry for profit_tests ('make test'), no framework needed.
+// Every TEST_CASE registers itself; a failed check throws and the runner
+// reports it and moves on to the next test.
+struct TestCase {
+    const char* name;
+    void (*body)();
+};
+
+std::vector<TestCase>& testRegistry();
+
+struct TestRegistration {
+    TestRegistration(const char* name, void (*body)()) { testRegistry().push_back({name, body}); }
+};
+
+struct TestFailure : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+#define TEST_CASE(name)                                              \
+    static void name();                                              \
+    static TestRegistration name##Registration(#name, name);         \
+    static void name()
+
+void checkTrue(bool condition, const char* expression, const char* file, int line);
+void checkNear(double actual, double expected, double relativeTolerance, const char* expression,
+               const char* file, int line);
+
+#define CHECK(condition) checkTrue((condition), #condition, __FILE__, __LINE__)
+
+// |actual - expected| <= tolerance * (1 + |expected|)
+#define CHECK_NEAR(actual, expected, tolerance) \
+    checkNear((actual), (expected), (tolerance), #actual, __FILE__, __LINE__)
+
+#define CHECK_THROWS(statement)                                                         \
+    do {                                                                                \
+        bool thrown = false;                                                            \
+        try {                                                                           \
+            statement;                                                                  \
+        } catch (const TestFailure&) {                                                  \
+            throw;                                                                      \
+        } catch (const std::exception&) {                                               \
+            thrown = true;                                                              \
+        }                                                                               \
+        checkTrue(thrown, #statement " throws", __FILE__, __LINE__);                    \
+    } while (0)
+
+// Path of a scratch file in this run's temporary directory
+std::string scratchPath(const std::string& name);
+
+#endif // TEST_UTIL_H
@@ -0,0 +1,138 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace {
+thread_local int workerIndex = -1;
+thread_local const ThreadPool* workerOwner = nullptr;
+}
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    queues.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::currentWorker() {
+    return workerIndex;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Workers keep their own children local; outside callers spread round-robin
+    unsigned target = (workerOwner == this && workerIndex >= 0)
+        ? static_cast<unsigned>(workerIndex)
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % size();
+
+    // Count the task before a thief can see it, queued must never dip below zero
+    pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queued.fetch_add(1);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+    }
+    wakeWorkers.notify_one();
+}
+
+bool ThreadPool::tryPop(unsigned self, std::function<void()>& task) {
+    // Own deque: newest first, keeps the working set warm
+    {
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        if (!queues[self]->tasks.empty()) {
+            task = std::move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Steal the oldest task from the other workers
+    for (unsigned offset = 1; offset < size(); ++offset) {
+        TaskQueue& victim = *queues[(self + offset) % size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned self) {
+    workerIndex = static_cast<int>(self);
+    workerOwner = this;
+
+    while (true) {
+        std::function<void()> task;
+        if (tryPop(self, task)) {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(stateMutex);
+        wakeWorkers.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return pending.load() == 0; });
+    if (firstError) {
+        std::exception_ptr error = firstError;
+        firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) return;
+
+    // A few chunks per worker leaves room for stealing on uneven work
+    size_t chunks = std::min(count, static_cast<size_t>(size()) * 4);
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        size_t end = std::min(count, begin + chunkSize);
+        submit([&body, begin, end] {
+            for (size_t i = begin; i < end; ++i) {
+                body(i);
+            }
+        });
+    }
+    wait();
+}
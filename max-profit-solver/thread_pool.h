@@ -0,0 +1,65 @@
+// thread_pool.h
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Every worker owns a deque: it pops its own
+// newest task first and steals the oldest task from other workers when idle.
+class ThreadPool {
+public:
+    // threads == 0 uses std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task. Tasks submitted from a worker go to that worker's deque.
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task has finished. Rethrows the first
+    // exception thrown by a task. Must not be called from a worker.
+    void wait();
+
+    // Run body(i) for i in [0, count) across the pool and wait for it.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    unsigned size() const { return static_cast<unsigned>(queues.size()); }
+
+    // Index of the calling worker in [0, size()), or -1 outside the pool
+    static int currentWorker();
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<size_t> queued{0};   // tasks sitting in a deque
+    std::atomic<size_t> pending{0};  // tasks submitted but not finished
+    std::atomic<unsigned> nextQueue{0};
+
+    std::mutex stateMutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable allDone;
+    bool stopping = false;
+    std::exception_ptr firstError;
+
+    bool tryPop(unsigned self, std::function<void()>& task);
+    void workerLoop(unsigned self);
+};
+
+#endif // THREAD_POOL_H
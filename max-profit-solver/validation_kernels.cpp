@@ -0,0 +1,369 @@
+#include "validation_kernels.h"
+#include "thread_pool.h"
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const size_t kLanes = 8;                    // Sum lanes, one AVX-512 register or two AVX2 registers
+const size_t kBlockSize = 16384;            // Products per task, a multiple of kLanes
+const size_t kParallelThreshold = 1 << 17;  // Smaller tables are checked on the calling thread
+
+enum class Isa { Scalar, Avx2, Avx512 };
+
+Isa detectIsa() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Isa::Avx512;
+    if (__builtin_cpu_supports("avx2")) return Isa::Avx2;
+#endif
+    return Isa::Scalar;
+}
+
+const Isa kIsa = detectIsa();
+
+// Fixed pairing so every instruction set rounds the same way
+double combineLanes(const double* lanes) {
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+// Run body(begin, end, block) over fixed size blocks, across a pool when the
+// table is large enough and we are not already on a pool worker (batch mode)
+template <typename Block, typename Body>
+std::vector<Block> forEachBlock(size_t count, unsigned threads, Body body) {
+    std::vector<Block> blocks((count + kBlockSize - 1) / kBlockSize);
+    auto runBlock = [&](size_t b) {
+        body(b * kBlockSize, std::min(count, (b + 1) * kBlockSize), blocks[b]);
+    };
+    if (blocks.size() > 1 && count >= kParallelThreshold && threads != 1 && ThreadPool::currentWorker() < 0) {
+        ThreadPool pool(threads);
+        pool.parallelFor(blocks.size(), runBlock);
+    } else {
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            runBlock(b);
+        }
+    }
+    return blocks;
+}
+
+template <typename Block>
+void appendIndices(std::vector<uint32_t>& out, const std::vector<Block>& blocks, std::vector<uint32_t> Block::* list) {
+    size_t total = 0;
+    for (const Block& block : blocks) total += (block.*list).size();
+    out.reserve(total);
+    for (const Block& block : blocks) {
+        out.insert(out.end(), (block.*list).begin(), (block.*list).end());
+    }
+}
+
+// ---- Input range checks ----
+
+struct RangeColumns {
+    const double* costMin;
+    const double* costMax;
+    const double* demandMin;
+    const double* demandMax;
+    const double* budgetMin;
+    const double* budgetMax;
+    const double* manHourPerUnitMin;
+    const double* manHourPerUnitMax;
+    const double* totalManHoursMax;
+};
+
+struct RangeLanes {
+    double minBudget[kLanes] = {};
+    double maxBudget[kLanes] = {};
+};
+
+// The exact tests validateInput reports on, run only for flagged products
+void classifyRange(const RangeColumns& c, size_t i, RangeViolations& out) {
+    double minBudget = c.costMin[i] * c.demandMin[i];
+    double maxBudget = c.costMax[i] * c.demandMax[i];
+    if (c.budgetMin[i] < minBudget || c.budgetMax[i] > maxBudget) {
+        out.budgetOutside.push_back(static_cast<uint32_t>(i));
+    } else if (c.budgetMin[i] > minBudget || c.budgetMax[i] < maxBudget) {
+        out.budgetNarrower.push_back(static_cast<uint32_t>(i));
+    }
+
+    double minManHours = c.manHourPerUnitMin[i] * c.demandMin[i];
+    double maxManHours = c.manHourPerUnitMax[i] * c.demandMax[i];
+    if (c.totalManHoursMax[i] > 0 && c.totalManHoursMax[i] < minManHours) {
+        out.manHoursBelow.push_back(static_cast<uint32_t>(i));
+    } else if (c.totalManHoursMax[i] > maxManHours) {
+        out.manHoursAbove.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+// Products [from, to) of the block starting at base, lane = (i - base) % kLanes
+void rangeScalar(const RangeColumns& c, size_t base, size_t from, size_t to, RangeViolations& out, RangeLanes& lanes) {
+    for (size_t i = from; i < to; ++i) {
+        double minBudget = c.costMin[i] * c.demandMin[i];
+        double maxBudget = c.costMax[i] * c.demandMax[i];
+        lanes.minBudget[(i - base) % kLanes] += minBudget;
+        lanes.maxBudget[(i - base) % kLanes] += maxBudget;
+
+        double minManHours = c.manHourPerUnitMin[i] * c.demandMin[i];
+        double maxManHours = c.manHourPerUnitMax[i] * c.demandMax[i];
+        bool budgetFlag = c.budgetMin[i] != minBudget || c.budgetMax[i] != maxBudget;
+        bool manHoursFlag = (c.totalManHoursMax[i] > 0 && c.totalManHoursMax[i] < minManHours) ||
+                            c.totalManHoursMax[i] > maxManHours;
+        if (budgetFlag || manHoursFlag) {
+            classifyRange(c, i, out);
+        }
+    }
+}
+
+#if defined(__x86_64__)
+
+// Bit per product of the four that may need a message
+__attribute__((target("avx2")))
+int rangeFlags4(const RangeColumns& c, size_t i, __m256d& minBudget, __m256d& maxBudget) {
+    __m256d demandMin = _mm256_loadu_pd(c.demandMin + i);
+    __m256d demandMax = _mm256_loadu_pd(c.demandMax + i);
+    minBudget = _mm256_mul_pd(_mm256_loadu_pd(c.costMin + i), demandMin);
+    maxBudget = _mm256_mul_pd(_mm256_loadu_pd(c.costMax + i), demandMax);
+    __m256d minManHours = _mm256_mul_pd(_mm256_loadu_pd(c.manHourPerUnitMin + i), demandMin);
+    __m256d maxManHours = _mm256_mul_pd(_mm256_loadu_pd(c.manHourPerUnitMax + i), demandMax);
+    __m256d totalManHours = _mm256_loadu_pd(c.totalManHoursMax + i);
+
+    __m256d flags = _mm256_or_pd(_mm256_cmp_pd(_mm256_loadu_pd(c.budgetMin + i), minBudget, _CMP_NEQ_OQ),
+                                 _mm256_cmp_pd(_mm256_loadu_pd(c.budgetMax + i), maxBudget, _CMP_NEQ_OQ));
+    __m256d below = _mm256_and_pd(_mm256_cmp_pd(totalManHours, _mm256_setzero_pd(), _CMP_GT_OQ),
+                                  _mm256_cmp_pd(totalManHours, minManHours, _CMP_LT_OQ));
+    flags = _mm256_or_pd(flags, _mm256_or_pd(below, _mm256_cmp_pd(totalManHours, maxManHours, _CMP_GT_OQ)));
+    return _mm256_movemask_pd(flags);
+}
+
+__attribute__((target("avx2")))
+void rangeAvx2(const RangeColumns& c, size_t begin, size_t end, RangeViolations& out, RangeLanes& lanes) {
+    __m256d minLow = _mm256_setzero_pd(), minHigh = _mm256_setzero_pd();
+    __m256d maxLow = _mm256_setzero_pd(), maxHigh = _mm256_setzero_pd();
+    size_t i = begin;
+    for (; i + kLanes <= end; i += kLanes) {
+        __m256d minBudget, maxBudget;
+        int low = rangeFlags4(c, i, minBudget, maxBudget);
+        minLow = _mm256_add_pd(minLow, minBudget);
+        maxLow = _mm256_add_pd(maxLow, maxBudget);
+        int high = rangeFlags4(c, i + 4, minBudget, maxBudget);
+        minHigh = _mm256_add_pd(minHigh, minBudget);
+        maxHigh = _mm256_add_pd(maxHigh, maxBudget);
+        for (int mask = low | (high << 4); mask != 0; mask &= mask - 1) {
+            classifyRange(c, i + __builtin_ctz(mask), out);
+        }
+    }
+    _mm256_storeu_pd(lanes.minBudget, minLow);
+    _mm256_storeu_pd(lanes.minBudget + 4, minHigh);
+    _mm256_storeu_pd(lanes.maxBudget, maxLow);
+    _mm256_storeu_pd(lanes.maxBudget + 4, maxHigh);
+    rangeScalar(c, begin, i, end, out, lanes);
+}
+
+__attribute__((target("avx512f")))
+void rangeAvx512(const RangeColumns& c, size_t begin, size_t end, RangeViolations& out, RangeLanes& lanes) {
+    __m512d minSum = _mm512_setzero_pd(), maxSum = _mm512_setzero_pd();
+    size_t i = begin;
+    for (; i + kLanes <= end; i += kLanes) {
+        __m512d demandMin = _mm512_loadu_pd(c.demandMin + i);
+        __m512d demandMax = _mm512_loadu_pd(c.demandMax + i);
+        __m512d minBudget = _mm512_mul_pd(_mm512_loadu_pd(c.costMin + i), demandMin);
+        __m512d maxBudget = _mm512_mul_pd(_mm512_loadu_pd(c.costMax + i), demandMax);
+        __m512d minManHours = _mm512_mul_pd(_mm512_loadu_pd(c.manHourPerUnitMin + i), demandMin);
+        __m512d maxManHours = _mm512_mul_pd(_mm512_loadu_pd(c.manHourPerUnitMax + i), demandMax);
+        __m512d totalManHours = _mm512_loadu_pd(c.totalManHoursMax + i);
+        minSum = _mm512_add_pd(minSum, minBudget);
+        maxSum = _mm512_add_pd(maxSum, maxBudget);
+
+        __mmask8 flags = _mm512_cmp_pd_mask(_mm512_loadu_pd(c.budgetMin + i), minBudget, _CMP_NEQ_OQ) |
+                         _mm512_cmp_pd_mask(_mm512_loadu_pd(c.budgetMax + i), maxBudget, _CMP_NEQ_OQ) |
+                         (_mm512_cmp_pd_mask(totalManHours, _mm512_setzero_pd(), _CMP_GT_OQ) &
+                          _mm512_cmp_pd_mask(totalManHours, minManHours, _CMP_LT_OQ)) |
+                         _mm512_cmp_pd_mask(totalManHours, maxManHours, _CMP_GT_OQ);
+        for (unsigned mask = flags; mask != 0; mask &= mask - 1) {
+            classifyRange(c, i + __builtin_ctz(mask), out);
+        }
+    }
+    _mm512_storeu_pd(lanes.minBudget, minSum);
+    _mm512_storeu_pd(lanes.maxBudget, maxSum);
+    rangeScalar(c, begin, i, end, out, lanes);
+}
+
+#endif
+
+// ---- Solved usage checks ----
+
+struct UsageColumns {
+    const double* units;
+    const double* unitCosts;
+    const double* unitManHours;
+    const double* budgetMin;
+    const double* budgetMax;
+    const double* totalManHoursMax;
+};
+
+struct UsageLanes {
+    double budget[kLanes] = {};
+    double manHours[kLanes] = {};
+};
+
+void usageScalar(const UsageColumns& c, size_t base, size_t from, size_t to, UsageViolations& out, UsageLanes& lanes) {
+    for (size_t i = from; i < to; ++i) {
+        double budgetUsed = c.units[i] * c.unitCosts[i];
+        double manHoursUsed = c.units[i] * c.unitManHours[i];
+        lanes.budget[(i - base) % kLanes] += budgetUsed;
+        lanes.manHours[(i - base) % kLanes] += manHoursUsed;
+        if (budgetUsed < c.budgetMin[i] || budgetUsed > c.budgetMax[i]) {
+            out.budget.push_back(static_cast<uint32_t>(i));
+        }
+        if (manHoursUsed > c.totalManHoursMax[i]) {
+            out.manHours.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("avx2")))
+void usageAvx2(const UsageColumns& c, size_t begin, size_t end, UsageViolations& out, UsageLanes& lanes) {
+    __m256d budgetSum[2] = {_mm256_setzero_pd(), _mm256_setzero_pd()};
+    __m256d manHoursSum[2] = {_mm256_setzero_pd(), _mm256_setzero_pd()};
+    size_t i = begin;
+    for (; i + kLanes <= end; i += kLanes) {
+        int budgetMask = 0, manHoursMask = 0;
+        for (int half = 0; half < 2; ++half) {
+            size_t j = i + 4 * half;
+            __m256d units = _mm256_loadu_pd(c.units + j);
+            __m256d budgetUsed = _mm256_mul_pd(units, _mm256_loadu_pd(c.unitCosts + j));
+            __m256d manHoursUsed = _mm256_mul_pd(units, _mm256_loadu_pd(c.unitManHours + j));
+            budgetSum[half] = _mm256_add_pd(budgetSum[half], budgetUsed);
+            manHoursSum[half] = _mm256_add_pd(manHoursSum[half], manHoursUsed);
+            __m256d budgetFlags = _mm256_or_pd(_mm256_cmp_pd(budgetUsed, _mm256_loadu_pd(c.budgetMin + j), _CMP_LT_OQ),
+                                               _mm256_cmp_pd(budgetUsed, _mm256_loadu_pd(c.budgetMax + j), _CMP_GT_OQ));
+            budgetMask |= _mm256_movemask_pd(budgetFlags) << (4 * half);
+            manHoursMask |= _mm256_movemask_pd(
+                _mm256_cmp_pd(manHoursUsed, _mm256_loadu_pd(c.totalManHoursMax + j), _CMP_GT_OQ)) << (4 * half);
+        }
+        for (int mask = budgetMask; mask != 0; mask &= mask - 1) {
+            out.budget.push_back(static_cast<uint32_t>(i + __builtin_ctz(mask)));
+        }
+        for (int mask = manHoursMask; mask != 0; mask &= mask - 1) {
+            out.manHours.push_back(static_cast<uint32_t>(i + __builtin_ctz(mask)));
+        }
+    }
+    _mm256_storeu_pd(lanes.budget, budgetSum[0]);
+    _mm256_storeu_pd(lanes.budget + 4, budgetSum[1]);
+    _mm256_storeu_pd(lanes.manHours, manHoursSum[0]);
+    _mm256_storeu_pd(lanes.manHours + 4, manHoursSum[1]);
+    usageScalar(c, begin, i, end, out, lanes);
+}
+
+__attribute__((target("avx512f")))
+void usageAvx512(const UsageColumns& c, size_t begin, size_t end, UsageViolations& out, UsageLanes& lanes) {
+    __m512d budgetSum = _mm512_setzero_pd(), manHoursSum = _mm512_setzero_pd();
+    size_t i = begin;
+    for (; i + kLanes <= end; i += kLanes) {
+        __m512d units = _mm512_loadu_pd(c.units + i);
+        __m512d budgetUsed = _mm512_mul_pd(units, _mm512_loadu_pd(c.unitCosts + i));
+        __m512d manHoursUsed = _mm512_mul_pd(units, _mm512_loadu_pd(c.unitManHours + i));
+        budgetSum = _mm512_add_pd(budgetSum, budgetUsed);
+        manHoursSum = _mm512_add_pd(manHoursSum, manHoursUsed);
+        unsigned budgetMask = _mm512_cmp_pd_mask(budgetUsed, _mm512_loadu_pd(c.budgetMin + i), _CMP_LT_OQ) |
+                              _mm512_cmp_pd_mask(budgetUsed, _mm512_loadu_pd(c.budgetMax + i), _CMP_GT_OQ);
+        unsigned manHoursMask = _mm512_cmp_pd_mask(manHoursUsed, _mm512_loadu_pd(c.totalManHoursMax + i), _CMP_GT_OQ);
+        for (; budgetMask != 0; budgetMask &= budgetMask - 1) {
+            out.budget.push_back(static_cast<uint32_t>(i + __builtin_ctz(budgetMask)));
+        }
+        for (; manHoursMask != 0; manHoursMask &= manHoursMask - 1) {
+            out.manHours.push_back(static_cast<uint32_t>(i + __builtin_ctz(manHoursMask)));
+        }
+    }
+    _mm512_storeu_pd(lanes.budget, budgetSum);
+    _mm512_storeu_pd(lanes.manHours, manHoursSum);
+    usageScalar(c, begin, i, end, out, lanes);
+}
+
+#endif
+
+} // namespace
+
+RangeViolations checkProductRanges(const ProductTable& products, unsigned threads) {
+    RangeColumns columns{
+        products.column(&Product::costMin).data(),
+        products.column(&Product::costMax).data(),
+        products.column(&Product::demandMin).data(),
+        products.column(&Product::demandMax).data(),
+        products.column(&Product::budgetMin).data(),
+        products.column(&Product::budgetMax).data(),
+        products.column(&Product::manHourPerUnitMin).data(),
+        products.column(&Product::manHourPerUnitMax).data(),
+        products.column(&Product::totalManHoursMax).data(),
+    };
+
+    auto blocks = forEachBlock<RangeViolations>(products.size(), threads,
+        [&columns](size_t begin, size_t end, RangeViolations& block) {
+            RangeLanes lanes;
+            switch (kIsa) {
+#if defined(__x86_64__)
+                case Isa::Avx512: rangeAvx512(columns, begin, end, block, lanes); break;
+                case Isa::Avx2: rangeAvx2(columns, begin, end, block, lanes); break;
+#endif
+                default: rangeScalar(columns, begin, begin, end, block, lanes); break;
+            }
+            block.totalMinBudget = combineLanes(lanes.minBudget);
+            block.totalMaxBudget = combineLanes(lanes.maxBudget);
+        });
+
+    RangeViolations result;
+    appendIndices(result.budgetOutside, blocks, &RangeViolations::budgetOutside);
+    appendIndices(result.budgetNarrower, blocks, &RangeViolations::budgetNarrower);
+    appendIndices(result.manHoursBelow, blocks, &RangeViolations::manHoursBelow);
+    appendIndices(result.manHoursAbove, blocks, &RangeViolations::manHoursAbove);
+    for (const RangeViolations& block : blocks) {
+        result.totalMinBudget += block.totalMinBudget;
+        result.totalMaxBudget += block.totalMaxBudget;
+    }
+    return result;
+}
+
+UsageViolations checkUsage(const double* units, const double* unitCosts, const double* unitManHours,
+                           const ProductTable& products, unsigned threads) {
+    UsageColumns columns{
+        units, unitCosts, unitManHours,
+        products.column(&Product::budgetMin).data(),
+        products.column(&Product::budgetMax).data(),
+        products.column(&Product::totalManHoursMax).data(),
+    };
+
+    auto blocks = forEachBlock<UsageViolations>(products.size(), threads,
+        [&columns](size_t begin, size_t end, UsageViolations& block) {
+            UsageLanes lanes;
+            switch (kIsa) {
+#if defined(__x86_64__)
+                case Isa::Avx512: usageAvx512(columns, begin, end, block, lanes); break;
+                case Isa::Avx2: usageAvx2(columns, begin, end, block, lanes); break;
+#endif
+                default: usageScalar(columns, begin, begin, end, block, lanes); break;
+            }
+            block.totalBudgetUsed = combineLanes(lanes.budget);
+            block.totalManHoursUsed = combineLanes(lanes.manHours);
+        });
+
+    UsageViolations result;
+    appendIndices(result.budget, blocks, &UsageViolations::budget);
+    appendIndices(result.manHours, blocks, &UsageViolations::manHours);
+    for (const UsageViolations& block : blocks) {
+        result.totalBudgetUsed += block.totalBudgetUsed;
+        result.totalManHoursUsed += block.totalManHoursUsed;
+    }
+    return result;
+}
+
+const char* validationKernelIsa() {
+    switch (kIsa) {
+        case Isa::Avx512: return "avx512";
+        case Isa::Avx2: return "avx2";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,41 @@
+// validation_kernels.h
+#ifndef VALIDATION_KERNELS_H
+#define VALIDATION_KERNELS_H
+
+#include "product_table.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Products failing each input range check, indices ascending. Only the
+// indices are gathered here, callers format messages for what they report.
+struct RangeViolations {
+    std::vector<uint32_t> budgetOutside;    // Budget range outside cost * demand
+    std::vector<uint32_t> budgetNarrower;   // Budget range inside but narrower
+    std::vector<uint32_t> manHoursBelow;    // Total man-hours below the minimum needed
+    std::vector<uint32_t> manHoursAbove;    // Total man-hours above the maximum usable
+    double totalMinBudget = 0.0;            // Sum of costMin * demandMin
+    double totalMaxBudget = 0.0;            // Sum of costMax * demandMax
+};
+
+// Products whose solved usage breaks their own rows, plus the global usage
+struct UsageViolations {
+    std::vector<uint32_t> budget;
+    std::vector<uint32_t> manHours;
+    double totalBudgetUsed = 0.0;
+    double totalManHoursUsed = 0.0;
+};
+
+// Both checks run blockwise across a thread pool (threads == 0 uses every
+// core) with AVX-512 or AVX2 when the CPU has them. Sums are accumulated in
+// a fixed lane and block order, so totals do not depend on the thread count
+// or the instruction set picked at run time.
+RangeViolations checkProductRanges(const ProductTable& products, unsigned threads = 0);
+
+UsageViolations checkUsage(const double* units, const double* unitCosts, const double* unitManHours,
+                           const ProductTable& products, unsigned threads = 0);
+
+// Instruction set the kernels dispatch to: "avx512", "avx2" or "scalar"
+const char* validationKernelIsa();
+
+#endif // VALIDATION_KERNELS_H